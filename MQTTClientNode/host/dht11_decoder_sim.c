@@ -0,0 +1,200 @@
+#include "dht11_decoder.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Waveform simulator for dht11_decode_frame(): builds the edge list the
+// manager's ISR would record for a random frame, distorted by sensor clock
+// skew, ISR latency and noise spikes, and prints the decode success rate.
+
+#define SIM_FRAMES          20000
+#define SIM_MAX_EDGES       96      // Same buffer size as dht11_manager.c
+#define SIM_SEED            0x2545F491u
+
+// Nominal sensor timing (microseconds) from the DHT11 datasheet
+#define SIM_WAIT_US         30      // Host release to sensor response (20-40us)
+#define SIM_RESPONSE_US     80      // Response LOW, then response HIGH
+#define SIM_BIT_LOW_US      50
+#define SIM_ZERO_HIGH_US    27
+#define SIM_ONE_HIGH_US     70
+
+typedef struct {
+    const char *name;
+    int skew_pct;           // Sensor clock off by up to +/- this much per frame
+    int jitter_us;          // ISR latency, uniform 0..jitter_us per edge
+    int glitch_pct;         // Chance of one 1-6us spike per frame
+    int min_success_pct;    // Test fails below this rate
+} sim_scenario_t;
+
+static const sim_scenario_t scenarios[] = {
+    { "nominal",            0,  2,  0, 100 },
+    { "skew 10%",          10,  2,  0, 100 },
+    { "skew 20%",          20,  2,  0,  99 },
+    { "jitter 10us",        0, 10,  0,  99 },
+    { "jitter 20us",        0, 20,  0,   0 },
+    { "glitches 50%",       0,  2, 50,  99 },
+    { "skew 10% + jitter 10us + glitches 20%", 10, 10, 20, 95 },
+};
+
+typedef struct {
+    uint32_t time_us;
+    uint8_t level;
+} sim_transition_t;
+
+static uint32_t rng_state = SIM_SEED;
+
+static uint32_t rng_next(void)
+{
+    // xorshift32: deterministic, so runs are comparable
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static int rng_range(int lo, int hi)
+{
+    return lo + (int)(rng_next() % (uint32_t)(hi - lo + 1));
+}
+
+/**
+ * @brief Build the true line transitions of one frame, starting at the host release
+ * 
+ * @return size_t Number of transitions
+ */
+static size_t sim_frame(const uint8_t data[5], int skew_pct, int glitch_pct, sim_transition_t *out, size_t cap)
+{
+    // Per-frame clock scale in permille
+    int scale = 1000 + rng_range(-skew_pct * 10, skew_pct * 10);
+    uint32_t t = 1000 + (uint32_t)rng_range(0, 50);
+    size_t n = 0;
+
+#define SIM_EDGE(lvl) do { out[n].time_us = t; out[n].level = (lvl); n++; } while (0)
+#define SIM_WAIT(us)  (t += (uint32_t)((us) * scale / 1000))
+
+    SIM_EDGE(1);                    // Host releases the line
+    SIM_WAIT(SIM_WAIT_US);
+    SIM_EDGE(0);                    // Response LOW
+    SIM_WAIT(SIM_RESPONSE_US);
+    SIM_EDGE(1);                    // Response HIGH
+    SIM_WAIT(SIM_RESPONSE_US);
+    for (int bit = 0; bit < 40; bit++) {
+        bool one = data[bit / 8] & (1 << (7 - (bit % 8)));
+        SIM_EDGE(0);
+        SIM_WAIT(SIM_BIT_LOW_US);
+        SIM_EDGE(1);
+        SIM_WAIT(one ? SIM_ONE_HIGH_US : SIM_ZERO_HIGH_US);
+    }
+    SIM_EDGE(0);                    // Trailing LOW, then the sensor releases the line
+    SIM_WAIT(SIM_BIT_LOW_US);
+    SIM_EDGE(1);
+
+#undef SIM_EDGE
+#undef SIM_WAIT
+
+    if (rng_range(1, 100) > glitch_pct) {
+        return n;
+    }
+
+    // Invert the line for 1-6us somewhere inside the frame
+    uint32_t at = out[1].time_us + (uint32_t)rng_range(0, (int)(out[n - 1].time_us - out[1].time_us));
+    uint32_t len = (uint32_t)rng_range(1, 6);
+    size_t pos = 0;
+    while (pos < n && out[pos].time_us <= at) {
+        pos++;
+    }
+    if (n + 2 > cap || pos == 0 || (pos < n && out[pos].time_us <= at + len)) {
+        return n;   // Spike would straddle a real edge: leave the frame clean
+    }
+    memmove(&out[pos + 2], &out[pos], (n - pos) * sizeof(out[0]));
+    out[pos].time_us = at;
+    out[pos].level = !out[pos - 1].level;
+    out[pos + 1].time_us = at + len;
+    out[pos + 1].level = out[pos - 1].level;
+    return n + 2;
+}
+
+// Line level at time t
+static uint8_t sim_level_at(const sim_transition_t *tr, size_t n, uint32_t t)
+{
+    uint8_t level = 0;
+    for (size_t i = 0; i < n && tr[i].time_us <= t; i++) {
+        level = tr[i].level;
+    }
+    return level;
+}
+
+/**
+ * @brief Record the transitions the way dht11_edge_isr() does
+ * 
+ * Each ISR runs jitter after its edge (and never before the previous one
+ * returned), stamps the time and samples the line, which may already have
+ * moved on. Edges beyond the buffer are lost.
+ */
+static size_t sim_capture(const sim_transition_t *tr, size_t n, int jitter_us, dht11_edge_t *edges)
+{
+    size_t count = 0;
+    uint32_t last = 0;
+
+    for (size_t i = 0; i < n && count < SIM_MAX_EDGES; i++) {
+        uint32_t t = tr[i].time_us + (uint32_t)rng_range(0, jitter_us);
+        if (count > 0 && t <= last) {
+            t = last + 1;
+        }
+        edges[count].time_us = t;
+        edges[count].level = sim_level_at(tr, n, t);
+        last = t;
+        count++;
+    }
+    return count;
+}
+
+int main(void)
+{
+    sim_transition_t transitions[SIM_MAX_EDGES + 2];
+    dht11_edge_t edges[SIM_MAX_EDGES];
+    int failed = 0;
+
+    printf("%-40s %8s %8s %8s %8s %8s\n", "scenario", "ok %", "no resp", "trunc", "crc", "wrong");
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        const sim_scenario_t *sc = &scenarios[s];
+        unsigned counts[4] = { 0 };
+        unsigned ok = 0;
+        unsigned wrong = 0;
+
+        for (int f = 0; f < SIM_FRAMES; f++) {
+            uint8_t data[5];
+            data[0] = (uint8_t)rng_range(5, 95);
+            data[1] = 0;
+            data[2] = (uint8_t)rng_range(0, 50);
+            data[3] = 0;
+            data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+
+            size_t n = sim_frame(data, sc->skew_pct, sc->glitch_pct, transitions,
+                                 sizeof(transitions) / sizeof(transitions[0]));
+            size_t count = sim_capture(transitions, n, sc->jitter_us, edges);
+
+            uint8_t decoded[5];
+            dht11_decode_status_t status = dht11_decode_frame(edges, count, decoded);
+            counts[status]++;
+            if (status == DHT11_DECODE_OK) {
+                if (memcmp(decoded, data, sizeof(data)) == 0) {
+                    ok++;
+                } else {
+                    wrong++;    // Checksum passed on a misread frame
+                }
+            }
+        }
+
+        double rate = 100.0 * ok / SIM_FRAMES;
+        printf("%-40s %8.2f %8u %8u %8u %8u\n", sc->name, rate, counts[DHT11_DECODE_NO_RESPONSE],
+               counts[DHT11_DECODE_BIT_TIMEOUT], counts[DHT11_DECODE_BAD_CHECKSUM], wrong);
+        if (rate < sc->min_success_pct) {
+            printf("  FAIL: expected at least %d%%\n", sc->min_success_pct);
+            failed = 1;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
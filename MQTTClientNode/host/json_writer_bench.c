@@ -0,0 +1,195 @@
+#include "json_writer.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if BENCH_HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+// Telemetry serialization cost: the streaming json_writer against the cJSON
+// tree + cJSON_PrintUnformatted() path it replaced, on the same message
+// (flat sample plus a two-sensor "dht11" and "hygrometer" array). Heap calls
+// are counted by wrapping malloc/calloc/realloc at link time (-Wl,--wrap).
+
+#define BENCH_MESSAGES      200000
+#define BENCH_BUF_SIZE      512
+
+static unsigned long bench_allocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    bench_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    bench_allocs++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    bench_allocs++;
+    return __real_realloc(ptr, size);
+}
+
+typedef struct {
+    int gpio;
+    int16_t temperature_x10;
+    int16_t humidity_x10;
+} bench_dht11_t;
+
+typedef struct {
+    int gpio;
+    uint16_t moisture_x100;
+} bench_hygro_t;
+
+static const bench_dht11_t dht11[] = { { 4, 235, 415 }, { 18, 241, 398 } };
+static const bench_hygro_t hygro[] = { { 34, 4217 }, { 35, 3862 } };
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static size_t encode_writer(char *buf, size_t cap, const char *timestamp)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, cap);
+    json_writer_begin_object(&w);
+    json_writer_key(&w, "client_id");
+    json_writer_string(&w, "esp32_node_01");
+    json_writer_key(&w, "ip");
+    json_writer_string(&w, "192.168.1.57");
+    json_writer_key(&w, "timestamp");
+    json_writer_string(&w, timestamp);
+    json_writer_key(&w, "temperature_c");
+    json_writer_fixed(&w, dht11[0].temperature_x10, 1);
+    json_writer_key(&w, "humidity_pct");
+    json_writer_fixed(&w, dht11[0].humidity_x10, 1);
+    json_writer_key(&w, "moisture_pct");
+    json_writer_fixed(&w, hygro[0].moisture_x100, 2);
+
+    json_writer_key(&w, "dht11");
+    json_writer_begin_array(&w);
+    for (size_t i = 0; i < sizeof(dht11) / sizeof(dht11[0]); i++) {
+        json_writer_begin_object(&w);
+        json_writer_key(&w, "gpio");
+        json_writer_int(&w, dht11[i].gpio);
+        json_writer_key(&w, "temperature_c");
+        json_writer_fixed(&w, dht11[i].temperature_x10, 1);
+        json_writer_key(&w, "humidity_pct");
+        json_writer_fixed(&w, dht11[i].humidity_x10, 1);
+        json_writer_end_object(&w);
+    }
+    json_writer_end_array(&w);
+
+    json_writer_key(&w, "hygrometer");
+    json_writer_begin_array(&w);
+    for (size_t i = 0; i < sizeof(hygro) / sizeof(hygro[0]); i++) {
+        json_writer_begin_object(&w);
+        json_writer_key(&w, "gpio");
+        json_writer_int(&w, hygro[i].gpio);
+        json_writer_key(&w, "moisture_pct");
+        json_writer_fixed(&w, hygro[i].moisture_x100, 2);
+        json_writer_end_object(&w);
+    }
+    json_writer_end_array(&w);
+
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+#if BENCH_HAVE_CJSON
+static size_t encode_cjson(char *buf, size_t cap, const char *timestamp)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "client_id", "esp32_node_01");
+    cJSON_AddStringToObject(root, "ip", "192.168.1.57");
+    cJSON_AddStringToObject(root, "timestamp", timestamp);
+    cJSON_AddNumberToObject(root, "temperature_c", dht11[0].temperature_x10 / 10.0);
+    cJSON_AddNumberToObject(root, "humidity_pct", dht11[0].humidity_x10 / 10.0);
+    cJSON_AddNumberToObject(root, "moisture_pct", hygro[0].moisture_x100 / 100.0);
+
+    cJSON *array = cJSON_AddArrayToObject(root, "dht11");
+    for (size_t i = 0; i < sizeof(dht11) / sizeof(dht11[0]); i++) {
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "gpio", dht11[i].gpio);
+        cJSON_AddNumberToObject(item, "temperature_c", dht11[i].temperature_x10 / 10.0);
+        cJSON_AddNumberToObject(item, "humidity_pct", dht11[i].humidity_x10 / 10.0);
+        cJSON_AddItemToArray(array, item);
+    }
+
+    array = cJSON_AddArrayToObject(root, "hygrometer");
+    for (size_t i = 0; i < sizeof(hygro) / sizeof(hygro[0]); i++) {
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "gpio", hygro[i].gpio);
+        cJSON_AddNumberToObject(item, "moisture_pct", hygro[i].moisture_x100 / 100.0);
+        cJSON_AddItemToArray(array, item);
+    }
+
+    // The publisher copied the printed string into its payload buffer
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    size_t len = 0;
+    if (json != NULL) {
+        len = strlen(json);
+        if (len < cap) {
+            memcpy(buf, json, len + 1);
+        } else {
+            len = 0;
+        }
+        cJSON_free(json);
+    }
+    return len;
+}
+#endif
+
+typedef size_t (*bench_encoder_t)(char *buf, size_t cap, const char *timestamp);
+
+static void bench_run(const char *name, bench_encoder_t encode)
+{
+    char buf[BENCH_BUF_SIZE];
+    char timestamps[60][32];
+    size_t bytes = 0;
+
+    // Formatted up front so the timed loop only serializes
+    for (int i = 0; i < 60; i++) {
+        snprintf(timestamps[i], sizeof(timestamps[i]), "2026-01-01T00:00:%02dZ", i);
+    }
+
+    // Warm up caches and the allocator, then show one message
+    size_t len = encode(buf, sizeof(buf), "2026-01-01T00:00:00Z");
+    printf("%s (%u bytes): %s\n", name, (unsigned)len, buf);
+
+    bench_allocs = 0;
+    double start = now_ns();
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        bytes += encode(buf, sizeof(buf), timestamps[i % 60]);
+    }
+    double elapsed_ns = now_ns() - start;
+    unsigned long allocs = bench_allocs;
+
+    printf("  %.1f MB/s, %.0f ns/message, %.1f allocations/message\n",
+           bytes / elapsed_ns * 1e3, elapsed_ns / BENCH_MESSAGES, (double)allocs / BENCH_MESSAGES);
+}
+
+int main(void)
+{
+    bench_run("json_writer", encode_writer);
+#if BENCH_HAVE_CJSON
+    bench_run("cJSON", encode_cjson);
+#else
+    printf("cJSON: not built (set IDF_PATH or CJSON_DIR, or install libcjson) - no comparison\n");
+#endif
+    return EXIT_SUCCESS;
+}
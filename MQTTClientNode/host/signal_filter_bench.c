@@ -0,0 +1,130 @@
+#include "signal_filter.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Variance of one ADC reading against the number of samples it is built
+// from: a plain mean of N conversions (the old one-shot path) versus the
+// Hampel + EMA pipeline fed N conversions per reading, with the filter
+// state kept between readings as adc_scanner does. Readings fewer than
+// ~2^CONFIG_ADC_FILTER_EMA_SHIFT samples apart share most of their EMA
+// history, so the filter column only reaches its steady-state variance for
+// large sample counts.
+
+#define BENCH_READINGS      4000
+#define BENCH_WARMUP        64          // Samples fed before the first reading
+#define BENCH_TRUE_CODE     2000        // Mid-scale 12-bit ADC code
+#define BENCH_NOISE_SIGMA   6.0         // Gaussian noise (codes)
+#define BENCH_SPIKE_PCT     5           // Share of samples hit by a spike
+#define BENCH_SPIKE_CODES   800         // Spike amplitude (WiFi TX burst on the supply)
+#define BENCH_SEED          0x9E3779B9u
+
+static const int sample_counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+static uint32_t rng_state = BENCH_SEED;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Uniform in (0, 1]
+static double rng_unit(void)
+{
+    return ((double)rng_next() + 1.0) / 4294967296.0;
+}
+
+// One raw conversion: true value + Gaussian noise (Box-Muller), sometimes a spike
+static int32_t adc_sample(void)
+{
+    double gauss = sqrt(-2.0 * log(rng_unit())) * cos(2.0 * M_PI * rng_unit());
+    int32_t code = BENCH_TRUE_CODE + (int32_t)lround(gauss * BENCH_NOISE_SIGMA);
+    if ((int)(rng_next() % 100) < BENCH_SPIKE_PCT) {
+        code += BENCH_SPIKE_CODES;
+    }
+    if (code < 0) code = 0;
+    if (code > 4095) code = 4095;
+    return code;
+}
+
+typedef struct {
+    double sum;
+    double sum_sq;
+    unsigned n;
+} bench_moments_t;
+
+static void moments_add(bench_moments_t *m, double x)
+{
+    m->sum += x;
+    m->sum_sq += x * x;
+    m->n++;
+}
+
+static double moments_mean(const bench_moments_t *m)
+{
+    return m->sum / m->n;
+}
+
+static double moments_variance(const bench_moments_t *m)
+{
+    double mean = moments_mean(m);
+    return m->sum_sq / m->n - mean * mean;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    printf("noise sigma %.1f codes, %d%% spikes of +%d codes, %d readings per row\n",
+           BENCH_NOISE_SIGMA, BENCH_SPIKE_PCT, BENCH_SPIKE_CODES, BENCH_READINGS);
+    printf("%8s | %12s %10s | %12s %10s %12s\n", "samples", "mean var", "mean bias",
+           "filter var", "filter bias", "ns/sample");
+
+    for (size_t c = 0; c < sizeof(sample_counts) / sizeof(sample_counts[0]); c++) {
+        int n = sample_counts[c];
+        bench_moments_t mean_stats = { 0 };
+        bench_moments_t filter_stats = { 0 };
+        double filter_ns = 0;
+
+        signal_filter_t filter;
+        signal_filter_init(&filter, CONFIG_ADC_FILTER_EMA_SHIFT, CONFIG_ADC_FILTER_HAMPEL_K_X10,
+                           CONFIG_ADC_FILTER_MIN_THRESHOLD);
+        for (int i = 0; i < BENCH_WARMUP; i++) {
+            signal_filter_update(&filter, adc_sample());
+        }
+
+        for (int r = 0; r < BENCH_READINGS; r++) {
+            int32_t samples[64];
+            int64_t sum = 0;
+            for (int i = 0; i < n; i++) {
+                samples[i] = adc_sample();
+                sum += samples[i];
+            }
+            moments_add(&mean_stats, (double)sum / n);
+
+            double start = now_ns();
+            for (int i = 0; i < n; i++) {
+                signal_filter_update(&filter, samples[i]);
+            }
+            filter_ns += now_ns() - start;
+            moments_add(&filter_stats, signal_filter_get(&filter));
+        }
+
+        printf("%8d | %12.2f %10.2f | %12.2f %10.2f %12.1f\n", n,
+               moments_variance(&mean_stats), moments_mean(&mean_stats) - BENCH_TRUE_CODE,
+               moments_variance(&filter_stats), moments_mean(&filter_stats) - BENCH_TRUE_CODE,
+               filter_ns / ((double)BENCH_READINGS * n));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,10 @@
 
 #include "esp_err.h"
 #include "esp_adc/adc_oneshot.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ADC_SCANNER_RAW_CODES 4096  // Number of raw codes of a 12-bit ADC1 conversion
 
 /**
  * @brief ADC scan result for a single GPIO
@@ -27,10 +31,26 @@ esp_err_t adc_scanner_init(void);
  */
 void adc_scanner_deinit(void);
 
+/**
+ * @brief Measure all ADC1 channels without logging
+ * 
+ * All channels are interleaved in a single DMA conversion pattern and
+ * de-interleaved into per-channel rings. With continuous sampling running on
+ * all channels this only averages the rings (microseconds); otherwise one
+ * ~25ms burst is run and the engine is stopped again.
+ * 
+ * @param results Array to store results (must have space for at least 6 entries)
+ * @param num_results Pointer to store number of results written
+ * @param max_results Maximum number of results to write
+ * 
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t adc_scanner_sweep(adc_scan_result_t *results, size_t *num_results, size_t max_results);
+
 /**
  * @brief Scan all ADC1 channels and report readings
  * 
- * Reads each ADC1 GPIO multiple times, averages the values,
+ * Sweeps every ADC1 GPIO (see adc_scanner_sweep()), logs the averaged values,
  * and flags channels that appear to have analog sensors connected
  * (i.e., not stuck at 0V or 3.3V rail).
  * 
@@ -42,9 +62,57 @@ void adc_scanner_deinit(void);
  */
 esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size_t max_results);
 
+/**
+ * @brief Sweep all ADC1 channels and log sensors that appeared or disappeared
+ * 
+ * Cheap enough to call periodically from the main loop for sensor-presence
+ * detection; only changes are logged.
+ * 
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t adc_scanner_check_presence(void);
+
+/**
+ * @brief Start background DMA sampling of ADC1 channels
+ * 
+ * Converts the given channels round-robin at CONFIG_ADC_CONTINUOUS_SAMPLE_HZ
+ * using the adc_continuous driver. A background task de-interleaves every
+ * DMA frame into a ring of the most recent CONFIG_ADC_CONTINUOUS_RING_SAMPLES
+ * samples per channel, so adc_scanner_read_gpio() becomes an averaging pass
+ * over the ring instead of a series of blocking one-shot conversions.
+ * 
+ * While running, ADC1 belongs to the DMA engine: one-shot reads of channels
+ * outside the pattern return ESP_ERR_NOT_SUPPORTED.
+ * 
+ * @param gpios ADC1 GPIOs to sample, NULL to interleave all six ADC1 channels
+ * @param num_gpios Number of entries in gpios (max 6, ignored if gpios is NULL)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t adc_scanner_continuous_start(const int *gpios, size_t num_gpios);
+
+/**
+ * @brief Stop background DMA sampling (one-shot reads are used again)
+ * 
+ * Waits for the drain task to exit before the driver is released. Engine
+ * start/stop, sweeps and reads are serialized, so this is safe to call while
+ * another task reads.
+ */
+void adc_scanner_continuous_stop(void);
+
+/**
+ * @brief Check whether background DMA sampling is running
+ * 
+ * @return true if adc_scanner_read_gpio() is served from the sample rings
+ */
+bool adc_scanner_continuous_running(void);
+
 /**
  * @brief Read a specific ADC1 channel multiple times and average
  * 
+ * With continuous sampling running this averages the most recent num_samples
+ * samples of the channel's ring (ESP_ERR_NOT_FINISHED before the first DMA
+ * frame). Otherwise it takes num_samples one-shot conversions 2ms apart.
+ * 
  * @param gpio_num GPIO number to read (must be ADC1 channel)
  * @param raw_out Pointer to store averaged raw value
  * @param voltage_mv_out Pointer to store voltage in mV
@@ -54,4 +122,44 @@ esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size
  */
 esp_err_t adc_scanner_read_gpio(int gpio_num, int *raw_out, int *voltage_mv_out, int num_samples);
 
+/**
+ * @brief Read the outlier-rejecting filtered value of an ADC1 channel
+ * 
+ * Every channel has a streaming filter (Hampel outlier rejection over a
+ * 7-sample running median, then a fixed-point EMA) that is updated one sample
+ * at a time and keeps its state between reads. With continuous sampling
+ * running, the drain task feeds it every DMA sample and this call only loads
+ * the output. Otherwise it takes num_samples one-shot conversions into the
+ * filter, far fewer than a plain average needs for the same noise floor.
+ * 
+ * @param gpio_num GPIO number to read (must be ADC1 channel)
+ * @param raw_out Pointer to store the filtered raw value
+ * @param voltage_mv_out Pointer to store voltage in mV
+ * @param num_samples One-shot conversions per call (default 8, ignored while continuous sampling runs)
+ * 
+ * @return ESP_OK on success, ESP_ERR_NOT_FINISHED before the first DMA frame,
+ *         error code otherwise
+ */
+esp_err_t adc_scanner_read_filtered(int gpio_num, int *raw_out, int *voltage_mv_out, int num_samples);
+
+/**
+ * @brief Read the filtered values of several ADC1 channels in one sequence
+ * 
+ * Same as adc_scanner_read_filtered() for a group of channels. In one-shot
+ * mode the conversions are interleaved (channel 0, 1, ..., n, then the next
+ * round), so reading n channels takes about as long as reading one.
+ * 
+ * @param gpios ADC1 GPIOs to read
+ * @param num_gpios Number of entries in gpios (max 6)
+ * @param raw_out Array receiving one filtered raw value per GPIO (may be NULL)
+ * @param voltage_mv_out Array receiving one voltage per GPIO (may be NULL)
+ * @param num_samples Conversion rounds per call (default 8, ignored while continuous sampling runs)
+ * 
+ * @return ESP_OK if every channel has a value, ESP_ERR_NOT_FINISHED if some
+ *         filters are still filling (their outputs are left untouched),
+ *         error code otherwise
+ */
+esp_err_t adc_scanner_read_filtered_group(const int *gpios, size_t num_gpios,
+                                          int *raw_out, int *voltage_mv_out, int num_samples);
+
 #endif // ADC_SCANNER_H
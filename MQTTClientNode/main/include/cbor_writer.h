@@ -0,0 +1,52 @@
+#ifndef CBOR_WRITER_H
+#define CBOR_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Minimal CBOR (RFC 8949) encoder over a caller-provided buffer
+ * 
+ * Only the subset used for telemetry: integers, text and byte strings,
+ * definite-length arrays and maps, null and booleans. Every integer uses the
+ * shortest encoding. Like json_writer, overflow is sticky and reported once
+ * by cbor_writer_finish().
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} cbor_writer_t;
+
+/**
+ * @brief Start writing into buf (cap bytes)
+ */
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t cap);
+
+void cbor_writer_uint(cbor_writer_t *w, uint64_t value);
+void cbor_writer_int(cbor_writer_t *w, int64_t value);
+void cbor_writer_text(cbor_writer_t *w, const char *value);
+void cbor_writer_bytes(cbor_writer_t *w, const void *data, size_t len);
+void cbor_writer_bool(cbor_writer_t *w, bool value);
+void cbor_writer_null(cbor_writer_t *w);
+
+/**
+ * @brief Start an array of count items (the next count values are its items)
+ */
+void cbor_writer_array(cbor_writer_t *w, size_t count);
+
+/**
+ * @brief Start a map of count pairs (the next 2 * count values are key, value, ...)
+ */
+void cbor_writer_map(cbor_writer_t *w, size_t count);
+
+/**
+ * @brief Get the encoded length
+ * 
+ * @return size_t Number of bytes written, 0 if the buffer overflowed
+ */
+size_t cbor_writer_finish(const cbor_writer_t *w);
+
+#endif // CBOR_WRITER_H
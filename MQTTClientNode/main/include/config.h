@@ -19,6 +19,85 @@
 #define CONFIG_MQTT_LWT_TOPIC     "disconnections"
 #define CONFIG_MQTT_KEEPALIVE     60  // seconds
 #define CONFIG_MQTT_QOS           1   // 0, 1, or 2
+// Broker failover: CONFIG_MQTT_BROKER_URI is the primary, the backups are tried in turn when the
+// current broker stays unreachable for CONFIG_MQTT_FAILOVER_TIMEOUT_MS. Every broker is probed (TCP
+// connect RTT) each CONFIG_MQTT_BROKER_PROBE_INTERVAL; a connected node moves to a healthy broker that
+// is faster by SWITCH_MARGIN_PCT, or back to an earlier one that is healthy and not slower by it.
+#define CONFIG_MQTT_BROKER_BACKUP_URIS       { NULL }  // NULL-terminated, e.g. { "mqtt://192.168.1.136", NULL }
+#define CONFIG_MQTT_MAX_BROKERS              4
+#define CONFIG_MQTT_FAILOVER_TIMEOUT_MS      15000  // Outage on one broker before trying the next
+#define CONFIG_MQTT_BROKER_PROBE_INTERVAL    30000  // Probe period (ms), also the fail-back check
+#define CONFIG_MQTT_BROKER_PROBE_PHASE_MS    450
+#define CONFIG_MQTT_BROKER_PROBE_TIMEOUT_MS  2000
+#define CONFIG_MQTT_BROKER_HEALTHY_PROBES    2      // Successful probes in a row to count as healthy
+#define CONFIG_MQTT_BROKER_SWITCH_MARGIN_PCT 30     // RTT difference needed to switch a working connection
+#define CONFIG_MQTT_BROKER_PUBACK_MAX_MS     2000   // Smoothed PUBACK latency above which a broker is avoided
+#define CONFIG_MQTT_PERSISTENT_SESSION 1  // Clean session off: broker keeps subscriptions and QoS 1 messages
+#define CONFIG_MQTT_RECONNECT_BASE_MS  1000   // First reconnect delay ceiling, doubled per failed attempt
+#define CONFIG_MQTT_RECONNECT_MAX_MS   60000  // Reconnect delay ceiling cap (actual delay is random below it)
+// TLS: with CONFIG_MQTT_TLS_ENABLED the broker URI must be mqtts://host:8883. The TLS session
+// (ticket or session ID) is cached across reconnects, so only the first handshake is a full one;
+// set CONFIG_MQTT_TLS_SESSION_RESUMPTION 0 to compare (tls_full / tls_resumed diagnostics stages).
+#define CONFIG_MQTT_TLS_ENABLED        0
+#define CONFIG_MQTT_TLS_SESSION_RESUMPTION 1  // Needs CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS=y
+#define CONFIG_MQTT_TLS_CA_PEM         NULL   // Broker CA certificate (PEM string), NULL for the ESP x509 bundle
+#define CONFIG_MQTT_TLS_COMMON_NAME    NULL   // Expected certificate name, NULL for the URI host
+#define CONFIG_MQTT_V5_ENABLED         1      // MQTT 5 (needs CONFIG_MQTT_PROTOCOL_5=y), falls back to 3.1.1 if refused
+#define CONFIG_MQTT_SESSION_EXPIRY_S   3600   // MQTT 5: how long the broker keeps a persistent session
+#define CONFIG_MQTT_TELEMETRY_EXPIRY_S 900    // MQTT 5: broker drops undelivered telemetry after this long
+#define CONFIG_TELEMETRY_SCHEMA_VERSION 1     // Payload schema (CBOR key 0, MQTT 5 "schema" user property); bump on incompatible changes
+#define CONFIG_MQTT_PAYLOAD_MAX   4096  // Telemetry payload buffer (bytes), serialized in place; larger batches are split
+#define CONFIG_MQTT_PAYLOAD_FORMAT 0    // 0 = JSON, 1 = CBOR (integer keys, ~3-5x smaller), 2 = both
+#define CONFIG_MQTT_CBOR_TOPIC    CONFIG_MQTT_TOPIC "/cbor/" CONFIG_MQTT_CLIENT_ID  // CBOR topic, carries the client ID
+#define CONFIG_MQTT_DIAG_TOPIC    CONFIG_MQTT_TOPIC "/diag/" CONFIG_MQTT_CLIENT_ID  // Diagnostics reports (QoS 0)
+
+// Batching: samples are queued and published together as one array payload, trading
+// latency for fewer PUBLISH/PUBACK round trips. A batch goes out when it holds
+// CONFIG_MQTT_BATCH_SIZE samples or its oldest sample reaches CONFIG_MQTT_BATCH_MAX_LATENCY_MS.
+// CONFIG_MQTT_BATCH_SIZE 1 publishes every sample immediately (no batching).
+#define CONFIG_MQTT_BATCH_SIZE           1
+#define CONFIG_MQTT_BATCH_MAX_LATENCY_MS 10000
+
+// Change-driven publishing: a sample is only published when some metric moved by more than
+// its deadband since the last published sample, a sensor gained or lost its reading, or
+// CONFIG_MQTT_HEARTBEAT_MS passed without a publish. Suppressed samples are counted, not sent.
+#define CONFIG_MQTT_DEADBAND_ENABLED          0
+#define CONFIG_MQTT_DEADBAND_TEMPERATURE_X10  5      // Tenths of a degree C (DHT11 steps are 1.0)
+#define CONFIG_MQTT_DEADBAND_HUMIDITY_X10     5      // Tenths of a percent (DHT11 steps are 1.0)
+#define CONFIG_MQTT_DEADBAND_MOISTURE_X100    50     // Hundredths of a percent
+#define CONFIG_MQTT_HEARTBEAT_MS              60000  // Publish at least this often even if nothing changed
+
+// Backpressure: QoS > 0 messages are tracked by msg_id until their PUBACK; beyond the window they
+// queue in the outbox below. The pressure (percent) reaches HIGH when the window is full and 100
+// when the outbox or the esp-mqtt outbox is full. At or above HIGH the publisher doubles its publish
+// interval (up to MAX_STRETCH, samples coalesce) and pauses the offline replay; at or below LOW it
+// halves it again. At 100 it falls back to QoS 0 (CONFIG_MQTT_BACKPRESSURE_QOS0 1) or holds its samples.
+#define CONFIG_MQTT_INFLIGHT_WINDOW           8      // Unacknowledged QoS > 0 messages allowed
+#define CONFIG_MQTT_INFLIGHT_TIMEOUT_MS       30000  // Forget a message without PUBACK after this long
+#define CONFIG_MQTT_OUTBOX_MAX_BYTES          16384  // Outbox size counted as 100% pressure
+#define CONFIG_MQTT_BACKPRESSURE_HIGH_PCT     50
+#define CONFIG_MQTT_BACKPRESSURE_LOW_PCT      25
+#define CONFIG_MQTT_BACKPRESSURE_MAX_STRETCH  8      // Power of two
+#define CONFIG_MQTT_BACKPRESSURE_QOS0         1
+
+// Outbox: QoS > 0 messages that cannot be handed to esp-mqtt yet (disconnected, window full)
+// wait in a static arena of CONFIG_MQTT_OUTBOX_BUDGET bytes instead of the heap. When it is full:
+// 0 = drop the oldest, 1 = drop the newest, 2 = coalesce (replace older messages on the same topic,
+// then drop the oldest). CONFIG_MQTT_OUTBOX_MAX_BYTES also caps the esp-mqtt outbox itself.
+#define CONFIG_MQTT_OUTBOX_BUDGET             8192
+#define CONFIG_MQTT_OUTBOX_POLICY             0
+
+// ============================================================================
+// Offline Store Configuration
+// ============================================================================
+// While MQTT is disconnected, admitted samples go to an append-only ring log on a
+// flash partition (see partitions.csv) instead of being dropped. They survive reboots
+// and are replayed after reconnect, a few per publish cycle, alongside live data.
+#define CONFIG_OFFLINE_STORE_ENABLED          1
+#define CONFIG_OFFLINE_STORE_PARTITION        "offline"  // Partition label
+#define CONFIG_OFFLINE_STORE_PARTITION_SUBTYPE 0x40      // Custom data subtype
+#define CONFIG_OFFLINE_STORE_WRITE_BATCH      8          // Records programmed per flash write (lost on power cut if staged)
+#define CONFIG_OFFLINE_STORE_DRAIN_PER_CYCLE  10         // Stored samples replayed per publish cycle
 
 // ============================================================================
 // Telnet Logger Configuration
@@ -46,17 +125,41 @@
 // DHT11 Sensor Configuration
 // ============================================================================
 #define CONFIG_DHT11_GPIO         22   // GPIO pin connected to DHT11 data pin (ignored if AUTO_SCAN enabled)
-#define CONFIG_DHT11_READ_INTERVAL 1000  // Minimum interval between reads (ms), DHT11 needs 2s min
-#define CONFIG_DHT11_AUTO_SCAN    0    // Set to 1 to auto-detect DHT11 GPIO, 0 to use CONFIG_DHT11_GPIO
+#define CONFIG_DHT11_GPIOS        { CONFIG_DHT11_GPIO }  // All DHT11 data pins, read in parallel, e.g. { 22, 23, 18, 19 }
+#define CONFIG_DHT11_MAX_SENSORS  8    // Max DHT11 sensors per node (one edge capture buffer each)
+#define CONFIG_DHT11_READ_INTERVAL 1000  // Sampling task period (ms), DHT11 needs 2s min
+#define CONFIG_DHT11_BREAKER_THRESHOLD 3       // Consecutive failed reads before a sensor is paused
+#define CONFIG_DHT11_BREAKER_BASE_MS   5000    // First backoff of a paused sensor (ms), doubles per failed retry
+#define CONFIG_DHT11_BREAKER_MAX_MS    300000  // Backoff ceiling (ms)
+#define CONFIG_DHT11_AUTO_SCAN    0    // Set to 1 to auto-detect DHT11 GPIOs (cached in NVS), 0 to use CONFIG_DHT11_GPIOS
+#define CONFIG_DHT11_SCAN_GPIOS   { 4, 5, 13, 14, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27 }  // Pins probed by auto-scan (driven LOW ~20ms, keep LED/busy pins out)
 
 // ============================================================================
 // ADC / Hygrometer Configuration
 // ============================================================================
 // Note: ADC2 (GPIO 0,2,4,12-15,25-27) cannot be used with WiFi enabled
 // Use ADC1 channels only: GPIO 32-39 (commonly 32,33,34,35,36,39)
-#define CONFIG_HYGROMETER_GPIO         32    // GPIO connected to hygrometer sensor (ADC1_CH4)
-#define CONFIG_HYGROMETER_READ_INTERVAL 1000 // Minimum interval between reads (ms)
-#define CONFIG_HYGROMETER_NUM_SAMPLES  64    // Number of ADC samples to average per reading
+#define CONFIG_HYGROMETER_GPIO         32    // GPIO of the first (or only) hygrometer probe (ADC1_CH4)
+#define CONFIG_HYGROMETER_MAX_PROBES   6     // One probe per ADC1 channel at most
+#define CONFIG_HYGROMETER_READ_INTERVAL 1000 // Sampling task period (ms)
+#define CONFIG_HYGROMETER_NUM_SAMPLES  8     // One-shot conversions fed to the filter per reading
+
+// Continuous (DMA) sampling: the ADC fills per-channel sample rings in the background and every
+// sample also passes through the channel's streaming filter, so a reading just loads the output.
+// All six ADC1 channels share the rate (~3.3kHz each at 20kHz).
+// Set to 0 to fall back to one-shot reads (CONFIG_HYGROMETER_NUM_SAMPLES conversions, 2ms apart).
+#define CONFIG_ADC_CONTINUOUS_ENABLED      1
+#define CONFIG_ADC_CONTINUOUS_SAMPLE_HZ    20000  // Total conversion rate, shared by all sampled channels (ESP32 min 20kHz)
+#define CONFIG_ADC_CONTINUOUS_FRAME_BYTES  1024   // DMA frame size (2 bytes per sample on ESP32)
+#define CONFIG_ADC_CONTINUOUS_RING_SAMPLES 512    // Most recent samples kept per channel (power of two)
+#define CONFIG_ADC_SCAN_INTERVAL           60000  // Sensor-presence sweep of all ADC1 channels (ms), 0 to disable
+
+// Streaming filter per ADC1 channel: Hampel outlier rejection, then an exponential average.
+// The filter keeps its state between readings, so spikes (WiFi TX, relay switching) are
+// replaced by the window median instead of dragging a plain average.
+#define CONFIG_ADC_FILTER_EMA_SHIFT        6      // EMA weight 1/2^shift (time constant ~64 samples)
+#define CONFIG_ADC_FILTER_HAMPEL_K_X10     30     // Reject samples beyond 3.0 sigma (MAD-based)
+#define CONFIG_ADC_FILTER_MIN_THRESHOLD    24     // Never reject deviations below this many raw codes
 
 // Calibration values: map ADC raw values to moisture percentage
 // Typical behavior: sensor reads higher voltage when dry, lower when wet
@@ -66,12 +169,42 @@
 #define CONFIG_HYGROMETER_DRY_VALUE    2850  // Raw ADC value when completely dry (0% moisture)
 #define CONFIG_HYGROMETER_WET_VALUE    1550  // Raw ADC value when completely wet (100% moisture)
 
+// Soil probes, one { ADC1 GPIO, dry value, wet value } entry per probe. Each probe is
+// calibrated on its own; all of them are sampled in the same conversion sequence.
+// Example for three probes:
+//   { { 32, 2850, 1550 }, { 33, 2790, 1480 }, { 34, 2900, 1600 } }
+#define CONFIG_HYGROMETER_PROBES { \
+    { CONFIG_HYGROMETER_GPIO, CONFIG_HYGROMETER_DRY_VALUE, CONFIG_HYGROMETER_WET_VALUE } \
+}
+
+// Raw -> moisture lookup tables, shared by all probes (2 bytes per entry). Each probe
+// takes (dry - wet) entries; probes that do not fit convert with a multiply instead.
+#define CONFIG_HYGROMETER_LUT_ENTRIES  4096
+
 // ============================================================================
 // Application Configuration
 // ============================================================================
-#define CONFIG_PUBLISH_INTERVAL   1000  // MQTT publish interval in milliseconds
+#define CONFIG_PUBLISH_INTERVAL   1000  // MQTT publish period in milliseconds (sensors are sampled by their own tasks)
 #define CONFIG_STARTUP_DELAY      2000   // Delay after init before starting main loop
 
+// Periodic jobs run on absolute deadlines (phase + k * period from boot), each on its
+// own task. Phases stagger jobs within a period so slow ones do not start together:
+// sampling first, then the publish picks up the fresh readings. Phase must be < period.
+#define CONFIG_SCHEDULER_MAX_JOBS          8
+#define CONFIG_DHT11_SAMPLE_PHASE_MS       0
+#define CONFIG_HYGROMETER_SAMPLE_PHASE_MS  100
+#define CONFIG_PUBLISH_PHASE_MS            300
+#define CONFIG_ADC_SCAN_PHASE_MS           600
+#define CONFIG_SCHEDULER_STATS_INTERVAL    60000  // Log jitter / missed-deadline counters (ms), 0 to disable
+
+// Diagnostics: pipeline stage latencies (sampling, timestamp, IP lookup, serialization,
+// enqueue, PUBACK) are kept in fixed histograms and reported as p50/p95/max on
+// CONFIG_MQTT_DIAG_TOPIC every CONFIG_DIAG_INTERVAL, one window per report, together
+// with the MQTT in-flight / backpressure counters.
+#define CONFIG_DIAG_INTERVAL               60000  // Diagnostics report period (ms), 0 to disable
+#define CONFIG_DIAG_PHASE_MS               900
+#define CONFIG_DIAG_PAYLOAD_MAX            2048   // Report buffer (bytes)
+
 // ============================================================================
 // Logging Configuration
 // ============================================================================
@@ -97,5 +230,9 @@
 #define CONFIG_LOG_LEVEL_DHT11    ESP_LOG_INFO   // DHT11 sensor logging
 #define CONFIG_LOG_LEVEL_ADC      ESP_LOG_INFO   // ADC scanner logging
 #define CONFIG_LOG_LEVEL_HYGRO    ESP_LOG_INFO   // Hygrometer logging
+#define CONFIG_LOG_LEVEL_OFFLINE  ESP_LOG_INFO   // Offline store logging
+#define CONFIG_LOG_LEVEL_SAMPLER  ESP_LOG_INFO   // Sensor sampling tasks logging
+#define CONFIG_LOG_LEVEL_SCHED    ESP_LOG_INFO   // Periodic job scheduler logging
+#define CONFIG_LOG_LEVEL_DIAG     ESP_LOG_INFO   // Diagnostics reports logging
 
 #endif // CONFIG_H
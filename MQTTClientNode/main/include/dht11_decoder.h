@@ -0,0 +1,43 @@
+#ifndef DHT11_DECODER_H
+#define DHT11_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Single edge recorded on the DHT11 data line
+ */
+typedef struct {
+    uint32_t time_us;   // Timestamp of the edge in microseconds (wraps freely)
+    uint8_t level;      // Line level after the edge (0 or 1)
+} dht11_edge_t;
+
+/**
+ * @brief Result of decoding a captured frame
+ */
+typedef enum {
+    DHT11_DECODE_OK = 0,        // 40 bits decoded and checksum valid
+    DHT11_DECODE_NO_RESPONSE,   // Sensor response pulse (~80us LOW + ~80us HIGH) not found
+    DHT11_DECODE_BIT_TIMEOUT,   // Response found but fewer than 40 bits captured
+    DHT11_DECODE_BAD_CHECKSUM   // 40 bits decoded but checksum mismatch
+} dht11_decode_status_t;
+
+/**
+ * @brief Decode a DHT11 frame from recorded edge timestamps
+ * 
+ * Pure function with no hardware access, so it can be exercised on the host
+ * with synthetic waveforms. The edge list is first cleaned in place: edges
+ * that do not change the level are dropped and spikes shorter than the glitch
+ * threshold are removed. Each bit is then timed falling edge to falling edge
+ * and classified against a threshold derived from the frame itself, which
+ * tolerates sensor clock skew and ISR latency far better than sampling the
+ * line at a fixed point in the bit.
+ * 
+ * @param edges Captured edges in chronological order (compacted in place)
+ * @param count Number of captured edges
+ * @param data Output: 5 bytes (humidity_int, humidity_dec, temp_int, temp_dec, checksum)
+ * @return dht11_decode_status_t DHT11_DECODE_OK on success
+ */
+dht11_decode_status_t dht11_decode_frame(dht11_edge_t *edges, size_t count, uint8_t data[5]);
+
+#endif // DHT11_DECODER_H
@@ -3,6 +3,8 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief DHT11 sensor data structure
@@ -14,12 +16,33 @@ typedef struct {
 } dht11_data_t;
 
 /**
- * @brief Initialize DHT11 sensor
+ * @brief Per-sensor read statistics and circuit breaker state
+ */
+typedef struct {
+    uint32_t reads_ok;              // Successful reads
+    uint32_t no_response;           // Sensor did not answer the start signal
+    uint32_t bit_timeout;           // Frame truncated before 40 bits
+    uint32_t crc_error;             // 40 bits received but checksum mismatch
+    uint32_t skipped;               // Reads skipped while the breaker was open
+    uint32_t consecutive_failures;  // Failed reads since the last success
+    uint32_t breaker_trips;         // Times the breaker opened
+    uint32_t backoff_ms;            // Current backoff, 0 when the breaker is closed
+    bool breaker_open;              // True while reads are paused
+} dht11_stats_t;
+
+/**
+ * @brief Initialize DHT11 sensors
+ * 
+ * Each sensor gets its own data line, edge ISR and capture buffer. All
+ * sensors are triggered and captured together, so a read of N sensors takes
+ * about as long as a read of one. Sensors are addressed by their index in
+ * gpio_nums.
  * 
- * @param gpio_num GPIO pin connected to DHT11 data pin
+ * @param gpio_nums GPIO pins connected to the DHT11 data pins
+ * @param num_sensors Number of entries in gpio_nums (1..CONFIG_DHT11_MAX_SENSORS)
  * @return esp_err_t ESP_OK if successful
  */
-esp_err_t dht11_manager_init(int gpio_num);
+esp_err_t dht11_manager_init(const int *gpio_nums, size_t num_sensors);
 
 /**
  * @brief Deinitialize DHT11 sensor
@@ -29,19 +52,88 @@ esp_err_t dht11_manager_init(int gpio_num);
 esp_err_t dht11_manager_deinit(void);
 
 /**
- * @brief Read temperature and humidity from DHT11 sensor
+ * @brief Get the number of configured sensors
+ * 
+ * @return size_t Sensor count, 0 if not initialized
+ */
+size_t dht11_manager_get_sensor_count(void);
+
+/**
+ * @brief Get the data GPIO of a sensor
+ * 
+ * @param sensor_idx Sensor index
+ * @return int GPIO number, -1 if the index is invalid
+ */
+int dht11_manager_get_gpio(size_t sensor_idx);
+
+/**
+ * @brief Start a non-blocking read of all DHT11 sensors
+ * 
+ * Pulls every data line LOW and returns immediately. An esp_timer ends the
+ * start signal and arms the edge capture, so the caller can do other work
+ * while the ~25ms transaction runs. Collect each sensor's result with
+ * dht11_manager_poll().
+ * 
+ * Sensors whose circuit breaker is open are left out of the read (no start
+ * signal, no interrupts) and report ESP_ERR_NOT_ALLOWED from poll.
+ * 
+ * @return esp_err_t ESP_OK if the read was started,
+ *         ESP_ERR_INVALID_STATE if not initialized or a read is already in progress,
+ *         ESP_ERR_NOT_FINISHED if the sensor is still stabilizing after init,
+ *         ESP_ERR_NOT_ALLOWED if every sensor is backing off
+ */
+esp_err_t dht11_manager_start_read(void);
+
+/**
+ * @brief Poll a read started with dht11_manager_start_read()
+ * 
+ * Decodes the captured frames once the transaction has completed. Each
+ * sensor's result is returned once; on success the reading is also cached
+ * for dht11_manager_get_cached().
+ * 
+ * The read completes early once every sensor has sent a full frame. A read
+ * still running past its deadline is closed by the next poll, and sensors
+ * whose frame is incomplete report ESP_ERR_TIMEOUT (and count as failed reads).
+ * 
+ * @param sensor_idx Sensor index
+ * @param data Pointer to structure to store sensor data
+ * @return esp_err_t ESP_OK if a new reading is available,
+ *         ESP_ERR_NOT_FINISHED while the read is still in progress,
+ *         ESP_ERR_INVALID_STATE if no read was started (or its result was already taken),
+ *         ESP_ERR_NOT_ALLOWED if the sensor was skipped by its circuit breaker,
+ *         ESP_ERR_TIMEOUT / ESP_ERR_INVALID_CRC if the read failed
+ */
+esp_err_t dht11_manager_poll(size_t sensor_idx, dht11_data_t *data);
+
+/**
+ * @brief Read temperature and humidity from one DHT11 sensor
  * 
  * This function performs a complete read cycle:
  * - Sends start signal to sensor
- * - Reads 40 bits of data (humidity + temperature + checksum)
+ * - Captures the sensor frame by timestamping GPIO edges in an ISR
+ * - Decodes 40 bits of data (humidity + temperature + checksum) from the pulse widths
  * - Validates checksum
  * 
+ * Blocking wrapper around dht11_manager_start_read() / dht11_manager_poll():
+ * the calling task sleeps (it does not spin) until the transaction completes.
+ * 
  * Note: DHT11 has ~1-2 second response time, don't poll faster than every 2 seconds
  * 
+ * @param sensor_idx Sensor index
  * @param data Pointer to structure to store sensor data
- * @return esp_err_t ESP_OK if read was successful, error otherwise
+ * @return esp_err_t ESP_OK if read was successful,
+ *         ESP_ERR_NOT_ALLOWED if the sensor's circuit breaker is open, error otherwise
+ */
+esp_err_t dht11_manager_read(size_t sensor_idx, dht11_data_t *data);
+
+/**
+ * @brief Read all DHT11 sensors in one blocking transaction
+ * 
+ * @param data Array receiving one reading per sensor (valid flag set per sensor)
+ * @param count Number of entries in data (extra entries are left untouched)
+ * @return esp_err_t ESP_OK if every sensor was read, otherwise the first sensor error
  */
-esp_err_t dht11_manager_read(dht11_data_t *data);
+esp_err_t dht11_manager_read_all(dht11_data_t *data, size_t count);
 
 /**
  * @brief Get last valid sensor reading (cached)
@@ -49,9 +141,23 @@ esp_err_t dht11_manager_read(dht11_data_t *data);
  * Returns the last successful reading without performing a new sensor read.
  * Useful for avoiding frequent sensor polling.
  * 
+ * @param sensor_idx Sensor index
  * @param data Pointer to structure to store cached sensor data
  * @return esp_err_t ESP_OK if cached data is available, ESP_ERR_INVALID_STATE if no valid data
  */
-esp_err_t dht11_manager_get_cached(dht11_data_t *data);
+esp_err_t dht11_manager_get_cached(size_t sensor_idx, dht11_data_t *data);
+
+/**
+ * @brief Get read statistics of a sensor
+ * 
+ * Failures are counted by kind. After CONFIG_DHT11_BREAKER_THRESHOLD failures
+ * in a row the sensor's circuit breaker opens and reads are skipped with an
+ * exponentially growing backoff, so a dead sensor costs almost nothing.
+ * 
+ * @param sensor_idx Sensor index
+ * @param stats Pointer to structure to store the statistics
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t dht11_manager_get_stats(size_t sensor_idx, dht11_stats_t *stats);
 
 #endif // DHT11_MANAGER_H
@@ -0,0 +1,55 @@
+#ifndef DHT11_SCANNER_H
+#define DHT11_SCANNER_H
+
+#include "esp_err.h"
+#include <stddef.h>
+
+/**
+ * @brief Probe candidate GPIOs for DHT11 sensors in a single pass
+ * 
+ * Sends one start signal on all candidate pins at once, timestamps the
+ * edges on every pin with GPIO interrupts (as the DHT11 manager does) and
+ * reports the pins that answer with the DHT11 response (~80us LOW followed
+ * by ~80us HIGH).
+ * 
+ * Candidate pins are driven LOW for ~20ms, so only list pins that are free or
+ * wired to a DHT11. Must run before dht11_manager_init() claims the pins.
+ * 
+ * @param candidates GPIO pins to probe (output-capable, 0-33)
+ * @param num_candidates Number of entries in candidates
+ * @param found Output: responding pins, in candidate order
+ * @param max_found Capacity of found
+ * @param num_found Output: number of responding pins written
+ * @return esp_err_t ESP_OK if at least one sensor answered,
+ *         ESP_ERR_NOT_FOUND if none did
+ */
+esp_err_t dht11_scanner_probe(const int *candidates, size_t num_candidates,
+                              int *found, size_t max_found, size_t *num_found);
+
+/**
+ * @brief Load the DHT11 pins detected on a previous boot from NVS
+ * 
+ * @param gpios Output: cached pins
+ * @param max_gpios Capacity of gpios
+ * @param num_gpios Output: number of cached pins
+ * @return esp_err_t ESP_OK if a cache entry was found, ESP_ERR_NOT_FOUND otherwise
+ */
+esp_err_t dht11_scanner_load_cached(int *gpios, size_t max_gpios, size_t *num_gpios);
+
+/**
+ * @brief Store detected DHT11 pins in NVS so later boots skip the probe
+ * 
+ * @param gpios Detected pins
+ * @param num_gpios Number of pins
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t dht11_scanner_save_cached(const int *gpios, size_t num_gpios);
+
+/**
+ * @brief Forget the cached pins (next boot probes again, e.g. after rewiring)
+ * 
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t dht11_scanner_clear_cached(void);
+
+#endif // DHT11_SCANNER_H
@@ -0,0 +1,39 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "esp_err.h"
+
+/**
+ * @brief Publish a diagnostics report on CONFIG_MQTT_DIAG_TOPIC
+ * 
+ * The report is a JSON object with the pipeline latency of the current
+ * window, one entry per stage (see latency_stats.h):
+ * 
+ *   {"client_id", "uptime_s", "window_s",
+ *    "latency": {"<stage>": {"n", "p50_us", "p95_us", "max_us", "mean_us"}, ...},
+ *    "mqtt": {"inflight", "inflight_peak", "acked", "expired", "rejected",
+ *             "outbox_bytes", "queued", "queued_bytes", "queued_peak_bytes",
+ *             "queue_dropped", "queue_coalesced", "protocol", "reconnects",
+ *             "reconnect_attempts", "last_reconnect_ms", "max_reconnect_ms",
+ *             "sessions_resumed", "broker", "failovers", "failbacks",
+ *             "last_failover_ms", "max_failover_ms", "pressure", "stretch",
+ *             "coalesced", "downgraded"},
+ *    "brokers": [{"healthy", "rtt_ms", "puback_ms", "probe_failures"}, ...],
+ *    "tls": {"full", "resumed", "failures", "full_heap_peak",
+ *            "resumed_heap_peak", "session_cached"}}
+ * 
+ * "brokers" is only present with backup brokers configured, "tls" only with
+ * CONFIG_MQTT_TLS_ENABLED.
+ * 
+ * The "mqtt" counters are cumulative (see mqtt_manager_get_stats() and
+ * mqtt_publisher_get_stats()). Stages without samples in the window are left out. The histograms are
+ * cleared once the report is handed to the MQTT client, so each report
+ * covers the time since the previous one. Meant to run as a scheduler job
+ * every CONFIG_DIAG_INTERVAL.
+ * 
+ * @return esp_err_t ESP_OK if published, ESP_ERR_INVALID_STATE if MQTT is
+ *         not connected (the window keeps growing), error code otherwise
+ */
+esp_err_t diagnostics_publish(void);
+
+#endif // DIAGNOSTICS_H
@@ -3,6 +3,8 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief Hygrometer sensor data
@@ -10,19 +12,32 @@
 typedef struct {
     int raw_value;          // Raw ADC reading (0-4095 for 12-bit)
     int voltage_mv;         // Voltage in millivolts
-    float moisture_percent; // Soil moisture percentage (0-100%)
+    uint16_t moisture_x100; // Soil moisture in hundredths of a percent (0-10000)
     bool valid;             // True if reading is valid
 } hygrometer_data_t;
 
+/**
+ * @brief Soil probe wiring and calibration
+ */
+typedef struct {
+    int gpio_num;           // ADC1 GPIO of the probe's analog output
+    int dry_value;          // Raw ADC value when completely dry (0% moisture)
+    int wet_value;          // Raw ADC value when completely wet (100% moisture)
+} hygrometer_probe_config_t;
+
 /**
  * @brief Initialize hygrometer manager
  * 
- * Configures the ADC channel for the specified GPIO and sets up calibration.
+ * Sets up one or more soil probes, one per ADC1 channel, each with its own
+ * calibration. Probes are addressed by their index in probes. All probes are
+ * sampled in one interleaved conversion sequence, so reading N probes takes
+ * about as long as reading one.
  * 
- * @param gpio_num GPIO number connected to hygrometer sensor (must be ADC1 channel)
+ * @param probes Probe GPIOs and calibrations (GPIOs must be ADC1 channels)
+ * @param num_probes Number of entries in probes (1..CONFIG_HYGROMETER_MAX_PROBES)
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t hygrometer_manager_init(int gpio_num);
+esp_err_t hygrometer_manager_init(const hygrometer_probe_config_t *probes, size_t num_probes);
 
 /**
  * @brief Deinitialize hygrometer manager and free resources
@@ -30,36 +45,67 @@ esp_err_t hygrometer_manager_init(int gpio_num);
 void hygrometer_manager_deinit(void);
 
 /**
- * @brief Read current hygrometer value
+ * @brief Get the number of configured probes
+ * 
+ * @return size_t Probe count, 0 if not initialized
+ */
+size_t hygrometer_manager_get_probe_count(void);
+
+/**
+ * @brief Get the ADC1 GPIO of a probe
  * 
- * Reads the ADC, averages multiple samples, and converts to percentage
- * using the configured calibration values (dry/wet thresholds).
+ * @param probe_idx Probe index
+ * @return int GPIO number, -1 if the index is invalid
+ */
+int hygrometer_manager_get_gpio(size_t probe_idx);
+
+/**
+ * @brief Read current hygrometer value of one probe
+ * 
+ * Reads the probe's filtered ADC value and converts it to percentage using
+ * the probe's calibration values (dry/wet thresholds). The conversion is a
+ * single load from a per-probe table precomputed from the calibration (or a
+ * fixed-point multiply if the table pool is full), so no floating point is used.
  * 
+ * @param probe_idx Probe index
  * @param data Pointer to store reading result
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t hygrometer_manager_read(hygrometer_data_t *data);
+esp_err_t hygrometer_manager_read(size_t probe_idx, hygrometer_data_t *data);
+
+/**
+ * @brief Read all probes in one conversion sequence
+ * 
+ * @param data Array receiving one reading per probe (valid flag set per probe)
+ * @param count Number of entries in data (extra entries are left untouched)
+ * @return ESP_OK if every probe was read, ESP_ERR_NOT_FINISHED if some probes
+ *         have no filtered value yet, error code otherwise
+ */
+esp_err_t hygrometer_manager_read_all(hygrometer_data_t *data, size_t count);
 
 /**
- * @brief Get cached hygrometer reading
+ * @brief Get cached hygrometer reading of one probe
  * 
  * Returns the last successful reading without performing a new ADC read.
  * 
+ * @param probe_idx Probe index
  * @param data Pointer to store cached reading
  * @return ESP_OK if cached data is valid, ESP_ERR_INVALID_STATE otherwise
  */
-esp_err_t hygrometer_manager_get_cached(hygrometer_data_t *data);
+esp_err_t hygrometer_manager_get_cached(size_t probe_idx, hygrometer_data_t *data);
 
 /**
- * @brief Set calibration values for moisture percentage calculation
+ * @brief Set calibration values of one probe
  * 
  * The sensor typically reads higher voltage when dry (air) and lower when wet (water).
- * These values map raw ADC readings to 0-100% moisture.
+ * These values map raw ADC readings to 0-100% moisture. The probe's
+ * fixed-point scale is recomputed on every change.
  * 
+ * @param probe_idx Probe index
  * @param dry_value Raw ADC value when sensor is completely dry (0% moisture)
  * @param wet_value Raw ADC value when sensor is completely wet (100% moisture)
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t hygrometer_manager_set_calibration(int dry_value, int wet_value);
+esp_err_t hygrometer_manager_set_calibration(size_t probe_idx, int dry_value, int wet_value);
 
 #endif // HYGROMETER_MANAGER_H
@@ -0,0 +1,74 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_WRITER_MAX_DEPTH  8   // Nested objects/arrays
+
+/**
+ * @brief Streaming JSON writer over a caller-provided buffer
+ * 
+ * Serializes directly into buf with no heap allocation. Values are written
+ * in call order; separators are inserted automatically. If the buffer runs
+ * out, the writer stops and json_writer_finish() reports the overflow, so
+ * callers only check once at the end.
+ */
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+    uint8_t depth;
+    uint8_t need_comma;   // Bit n set: container at depth n already holds a value
+    bool after_key;       // Next value follows a key, no comma
+} json_writer_t;
+
+/**
+ * @brief Start writing into buf (cap bytes including the terminator)
+ */
+void json_writer_init(json_writer_t *w, char *buf, size_t cap);
+
+void json_writer_begin_object(json_writer_t *w);
+void json_writer_end_object(json_writer_t *w);
+void json_writer_begin_array(json_writer_t *w);
+void json_writer_end_array(json_writer_t *w);
+
+/**
+ * @brief Write an object key (the next call writes its value)
+ * 
+ * @param key Key, written as-is (must not need escaping)
+ */
+void json_writer_key(json_writer_t *w, const char *key);
+
+/**
+ * @brief Write a string value, escaping quotes, backslashes and control characters
+ */
+void json_writer_string(json_writer_t *w, const char *value);
+
+/**
+ * @brief Write an integer value
+ */
+void json_writer_int(json_writer_t *w, int32_t value);
+
+/**
+ * @brief Write a fixed-point number: value / 10^decimals (e.g. 2345, 2 -> 23.45)
+ * 
+ * @param value Scaled integer value
+ * @param decimals Digits after the decimal point (0-4)
+ */
+void json_writer_fixed(json_writer_t *w, int32_t value, uint8_t decimals);
+
+void json_writer_bool(json_writer_t *w, bool value);
+void json_writer_null(json_writer_t *w);
+
+/**
+ * @brief Terminate the output
+ * 
+ * @return size_t Length of the JSON text, 0 if the buffer overflowed or the
+ *         containers are not balanced
+ */
+size_t json_writer_finish(json_writer_t *w);
+
+#endif // JSON_WRITER_H
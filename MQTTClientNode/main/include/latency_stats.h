@@ -0,0 +1,70 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Instrumented stages of the sample-to-broker pipeline
+ */
+typedef enum {
+    LATENCY_STAGE_DHT11_READ = 0,   // DHT11 sampling job (start signal to decoded frames)
+    LATENCY_STAGE_ADC_READ,         // Hygrometer sampling job (conversion sequence and filtering)
+    LATENCY_STAGE_TIMESTAMP,        // Wall-clock timestamp of a sample
+    LATENCY_STAGE_IP_LOOKUP,        // Local IP lookup for the payload
+    LATENCY_STAGE_SERIALIZE,        // Encoding one payload
+    LATENCY_STAGE_ENQUEUE,          // Handing one payload to esp-mqtt
+    LATENCY_STAGE_PUBACK,           // Enqueue to PUBACK (QoS > 0), matched by msg_id in mqtt_manager
+    LATENCY_STAGE_CYCLE,            // Whole mqtt_publish_sensor_data() call
+    LATENCY_STAGE_TLS_FULL,         // TLS handshake without a cached session (mqtt_tls)
+    LATENCY_STAGE_TLS_RESUMED,      // TLS handshake offering the cached session
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+/**
+ * @brief Summary of one stage's histogram
+ */
+typedef struct {
+    uint32_t count;     // Durations recorded
+    uint32_t p50_us;    // Median (bucket-interpolated)
+    uint32_t p95_us;    // 95th percentile (bucket-interpolated)
+    uint32_t max_us;    // Exact maximum
+    uint32_t mean_us;   // Exact mean
+} latency_summary_t;
+
+/**
+ * @brief Record a stage duration
+ * 
+ * Durations go into a fixed log-linear histogram (four buckets per
+ * power-of-two octave, 1us .. ~16s, longer values land in the last bucket,
+ * percentiles within ~12%); recording takes a
+ * spinlock for a few instructions and never allocates. Safe from any task.
+ * 
+ * @param stage Stage
+ * @param duration_us Duration in microseconds (negative values are ignored)
+ */
+void latency_record(latency_stage_t stage, int64_t duration_us);
+
+/**
+ * @brief Get the summary of a stage
+ * 
+ * @param stage Stage
+ * @param summary Output: count, p50, p95, max, mean
+ */
+void latency_get_summary(latency_stage_t stage, latency_summary_t *summary);
+
+/**
+ * @brief Get the short name of a stage (diagnostics key)
+ * 
+ * @param stage Stage
+ * @return const char* Name, "unknown" if out of range
+ */
+const char *latency_stage_name(latency_stage_t stage);
+
+/**
+ * @brief Clear every histogram (start a new reporting window)
+ */
+void latency_reset(void);
+
+#endif // LATENCY_STATS_H
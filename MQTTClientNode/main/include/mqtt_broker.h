@@ -0,0 +1,96 @@
+#ifndef MQTT_BROKER_H
+#define MQTT_BROKER_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Health of one broker in the list
+ */
+typedef struct {
+    const char *uri;
+    bool healthy;               // Last CONFIG_MQTT_BROKER_HEALTHY_PROBES probes succeeded
+    uint32_t rtt_ms;            // Smoothed TCP connect time of the probes, 0 until measured
+    uint32_t puback_ms;         // Smoothed PUBACK latency while active, 0 otherwise
+    uint32_t probes;            // Probes run
+    uint32_t probe_failures;    // Probes that failed or timed out
+} mqtt_broker_info_t;
+
+/**
+ * @brief Build the broker list: the primary, then CONFIG_MQTT_BROKER_BACKUP_URIS
+ * 
+ * @param primary_uri First (preferred) broker
+ * @return esp_err_t ESP_OK if successful, ESP_ERR_INVALID_ARG if primary_uri is NULL
+ */
+esp_err_t mqtt_broker_init(const char *primary_uri);
+
+/**
+ * @brief Number of brokers in the list
+ * 
+ * @return size_t Count (1 without backups)
+ */
+size_t mqtt_broker_count(void);
+
+/**
+ * @brief Get the URI of a broker
+ * 
+ * @param index Position in the list (0 = primary)
+ * @return const char* URI, NULL if out of range
+ */
+const char *mqtt_broker_uri(int index);
+
+/**
+ * @brief Probe every broker with a TCP connect and update its health
+ * 
+ * Each probe opens and closes a plain TCP connection to the broker port
+ * (no MQTT traffic) with a CONFIG_MQTT_BROKER_PROBE_TIMEOUT_MS timeout and
+ * feeds the connect time into the broker's smoothed RTT. Blocks for up to
+ * count * timeout: call it from a low-priority periodic job.
+ */
+void mqtt_broker_probe_all(void);
+
+/**
+ * @brief Record a PUBACK latency of the active broker
+ * 
+ * @param index Active broker
+ * @param latency_us Enqueue to PUBACK
+ */
+void mqtt_broker_record_puback(int index, int64_t latency_us);
+
+/**
+ * @brief Mark the broker now in use (clears the PUBACK latency of the others)
+ * 
+ * @param index Active broker
+ */
+void mqtt_broker_set_active(int index);
+
+/**
+ * @brief Pick the broker to use
+ * 
+ * Candidates are healthy brokers whose PUBACK latency (if known) is within
+ * CONFIG_MQTT_BROKER_PUBACK_MAX_MS; the current one counts only if
+ * current_up. A candidate beats another when its RTT is lower by more than
+ * CONFIG_MQTT_BROKER_SWITCH_MARGIN_PCT, or when it comes earlier in the list
+ * and is not slower by more than that margin (fail-back to the primary).
+ * Without any candidate the current broker is kept while it is connected
+ * (even if its PUBACK latency is over the limit), and the next broker in the
+ * list is returned otherwise, so an outage still rotates through the list.
+ * 
+ * @param current Broker in use
+ * @param current_up Whether the current broker is connected
+ * @return int Broker to use (current to stay)
+ */
+int mqtt_broker_select(int current, bool current_up);
+
+/**
+ * @brief Get the health of a broker
+ * 
+ * @param index Position in the list
+ * @param info Output: health
+ * @return esp_err_t ESP_OK if successful, ESP_ERR_INVALID_ARG if out of range
+ */
+esp_err_t mqtt_broker_get_info(int index, mqtt_broker_info_t *info);
+
+#endif // MQTT_BROKER_H
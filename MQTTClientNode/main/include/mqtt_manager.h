@@ -2,11 +2,61 @@
 #define MQTT_MANAGER_H
 
 #include "esp_err.h"
+#include "mqtt_outbox.h"
+#include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief In-flight (QoS > 0) message, outbox and reconnect counters
+ */
+typedef struct {
+    uint32_t inflight;          // Messages awaiting their PUBACK
+    uint32_t inflight_peak;     // Highest inflight since boot
+    uint32_t acked;             // PUBACKs received
+    uint32_t expired;           // Dropped by the esp-mqtt outbox or timed out unacknowledged
+    uint32_t rejected;          // QoS > 0 publishes refused by the outbox policy
+    int outbox_bytes;           // Current esp-mqtt outbox size
+    mqtt_outbox_stats_t queue;  // Budgeted outbox in front of esp-mqtt
+    uint32_t reconnects;        // Connections re-established after a loss
+    uint32_t reconnect_attempts;// Backoff-timed connection attempts
+    uint32_t last_reconnect_ms; // Connection loss to CONNECTED, last reconnect
+    uint32_t max_reconnect_ms;  // Longest time to reconnect
+    uint32_t sessions_resumed;  // CONNACKs with session_present (persistent session kept)
+    bool protocol_v5;           // Using MQTT 5 (false: 3.1.1, by configuration or fallback)
+    int active_broker;          // Index in the broker list (0 = primary, see mqtt_broker.h)
+    uint32_t failovers;         // Switches to a later broker in the list
+    uint32_t failbacks;         // Switches to an earlier broker in the list
+    uint32_t last_failover_ms;  // Leaving a broker to CONNECTED on the next one, last switch
+    uint32_t max_failover_ms;   // Longest switch
+} mqtt_manager_stats_t;
 
 /**
  * @brief Initialize and connect MQTT client
  * 
+ * With CONFIG_MQTT_PERSISTENT_SESSION the client connects with
+ * clean-session off, so subscriptions and unacknowledged QoS 1 messages
+ * survive a reconnect. esp-mqtt's fixed-delay auto-reconnect is disabled:
+ * after a disconnect or failed attempt the next one waits a random delay in
+ * [0, min(CONFIG_MQTT_RECONNECT_MAX_MS, CONFIG_MQTT_RECONNECT_BASE_MS * 2^n)]
+ * so nodes dropped by the same broker restart do not reconnect together.
+ * 
+ * With CONFIG_MQTT_V5_ENABLED (and esp-mqtt built with
+ * CONFIG_MQTT_PROTOCOL_5) the client negotiates MQTT 5: the telemetry and
+ * diagnostics topics use topic aliases and a message expiry interval, every
+ * publish carries a "schema" user property, and the session expiry interval
+ * is CONFIG_MQTT_SESSION_EXPIRY_S. If the broker refuses the protocol
+ * version, the following attempts use MQTT 3.1.1.
+ * 
+ * broker_uri is the primary broker; CONFIG_MQTT_BROKER_BACKUP_URIS are the
+ * failover candidates (see mqtt_manager_check_brokers()). While no broker
+ * is connected, the current one is tried for CONFIG_MQTT_FAILOVER_TIMEOUT_MS
+ * (backoff delays are cut short to keep that bound) before the next attempt
+ * goes to the best other broker.
+ * 
+ * With CONFIG_MQTT_TLS_ENABLED (mqtts:// URI) the connection runs over
+ * mqtt_tls_transport_create(), which resumes the TLS session on reconnect.
+ * 
  * @param broker_uri MQTT broker URI (e.g.: "mqtt://192.168.1.250")
  * @param client_id Unique client ID
  * @param ip_address Client IP address (for Last Will)
@@ -32,6 +82,71 @@ esp_err_t mqtt_manager_deinit(void);
  */
 int mqtt_manager_publish(const char *topic, const char *message, int qos, int retain);
 
+/**
+ * @brief Publish a binary payload to an MQTT topic
+ * 
+ * Same as mqtt_manager_publish() for payloads that are not NUL-terminated
+ * text (e.g. CBOR).
+ * 
+ * QoS > 0 messages are tracked by msg_id until MQTT_EVENT_PUBLISHED (PUBACK)
+ * or MQTT_EVENT_DELETED. At most CONFIG_MQTT_INFLIGHT_WINDOW may be
+ * outstanding in esp-mqtt; while the window is full or the client is
+ * disconnected, new ones wait in a fixed CONFIG_MQTT_OUTBOX_BUDGET arena
+ * (see mqtt_outbox.h) whose overflow policy is CONFIG_MQTT_OUTBOX_POLICY,
+ * so memory use stays bounded during broker outages. Queued messages are
+ * sent first, on the next publish or mqtt_manager_process_outbox().
+ * QoS 0 messages bypass the outbox.
+ * 
+ * @param topic Topic to publish to
+ * @param data Payload bytes
+ * @param len Payload length in bytes
+ * @param qos Quality of Service (0, 1 or 2)
+ * @param retain Whether the message should be retained by the broker
+ * @return int Published message ID, 0 if queued in the outbox, -1 if failed
+ *         or refused by the outbox policy
+ */
+int mqtt_manager_publish_bin(const char *topic, const void *data, size_t len, int qos, int retain);
+
+/**
+ * @brief Publish binary data only if it can be handed to esp-mqtt now
+ * 
+ * Same as mqtt_manager_publish_bin() but never queues in the outbox, whose
+ * policy may evict a message before it is sent. For callers that keep their
+ * own durable copy (offline replay) and may only drop it once esp-mqtt has
+ * the message.
+ * 
+ * @param topic Topic to publish to
+ * @param data Payload bytes
+ * @param len Payload length in bytes
+ * @param qos Quality of Service (0, 1 or 2)
+ * @param retain Whether the message should be retained by the broker
+ * @return int Published message ID, -2 if it would have been queued
+ *         (disconnected, window full, or older messages still queued), -1 if failed
+ */
+int mqtt_manager_publish_bin_now(const char *topic, const void *data, size_t len, int qos, int retain);
+
+/**
+ * @brief Probe the broker list and move to a better broker if there is one
+ * 
+ * Runs mqtt_broker_probe_all() (blocking, up to one probe timeout per
+ * broker), then, while connected, asks mqtt_broker_select() whether another
+ * broker is clearly faster, healthier (PUBACK latency), or an earlier list
+ * entry that is healthy again (fail-back). If so the client disconnects and
+ * reconnects there. Sessions are per broker: the new broker starts without
+ * this client's session, and only messages still in esp-mqtt's local outbox
+ * are resent to it. Does nothing with a single broker. Call periodically
+ * (CONFIG_MQTT_BROKER_PROBE_INTERVAL) from a low-priority job.
+ */
+void mqtt_manager_check_brokers(void);
+
+/**
+ * @brief Send queued outbox messages while the in-flight window has room
+ * 
+ * Call periodically from a publishing task (not from MQTT event handlers)
+ * so the outbox drains after a reconnect even when nothing new is published.
+ */
+void mqtt_manager_process_outbox(void);
+
 /**
  * @brief Subscribe to an MQTT topic
  * 
@@ -49,6 +164,26 @@ int mqtt_manager_subscribe(const char *topic, int qos);
  */
 int mqtt_manager_unsubscribe(const char *topic);
 
+/**
+ * @brief Current publish backpressure
+ * 
+ * The largest of the budgeted outbox use and the esp-mqtt outbox size
+ * relative to CONFIG_MQTT_OUTBOX_MAX_BYTES, in percent, and of the in-flight
+ * window use scaled so that a full window reads as
+ * CONFIG_MQTT_BACKPRESSURE_HIGH_PCT. At 100 or more, new QoS > 0 publishes
+ * fall to the outbox policy.
+ * 
+ * @return uint32_t Pressure in percent (may exceed 100 for the outbox)
+ */
+uint32_t mqtt_manager_get_pressure(void);
+
+/**
+ * @brief Get in-flight message counters
+ * 
+ * @param stats Output: counters since init
+ */
+void mqtt_manager_get_stats(mqtt_manager_stats_t *stats);
+
 /**
  * @brief Check if MQTT client is connected
  * 
@@ -0,0 +1,89 @@
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief What to give up when a message does not fit the outbox budget
+ */
+typedef enum {
+    MQTT_OUTBOX_DROP_OLDEST = 0,    // Evict the oldest queued messages (freshest data wins)
+    MQTT_OUTBOX_DROP_NEWEST,        // Refuse the incoming message (queued history wins)
+    MQTT_OUTBOX_COALESCE,           // Evict older messages on the same topic first, then the oldest
+} mqtt_outbox_policy_t;
+
+/**
+ * @brief A queued message, pointing into the outbox memory
+ */
+typedef struct {
+    const char *topic;
+    const void *data;
+    size_t len;
+    int qos;
+    int retain;
+} mqtt_outbox_msg_t;
+
+/**
+ * @brief Outbox counters
+ */
+typedef struct {
+    uint32_t count;             // Messages queued now
+    uint32_t bytes;             // Budget in use now (headers, topics and payloads)
+    uint32_t peak_bytes;        // Highest bytes since init
+    uint32_t queued;            // Messages accepted
+    uint32_t sent;              // Messages handed on (popped)
+    uint32_t dropped;           // Messages lost to the policy (evicted or refused)
+    uint32_t coalesced;         // Messages replaced by a newer one on the same topic
+} mqtt_outbox_stats_t;
+
+/**
+ * @brief Reset the outbox
+ * 
+ * The outbox is a FIFO of messages packed into a static arena of
+ * CONFIG_MQTT_OUTBOX_BUDGET bytes: it never allocates, so its memory use is
+ * fixed at link time whatever the broker does.
+ * 
+ * Not thread-safe: the caller (mqtt_manager) serializes every call.
+ * 
+ * @param policy Overflow policy
+ */
+void mqtt_outbox_init(mqtt_outbox_policy_t policy);
+
+/**
+ * @brief Queue a message, applying the overflow policy if the budget is full
+ * 
+ * @param topic Topic (copied)
+ * @param data Payload (copied)
+ * @param len Payload length in bytes
+ * @param qos Quality of Service
+ * @param retain Retain flag
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NO_MEM if refused
+ *         (MQTT_OUTBOX_DROP_NEWEST), ESP_ERR_INVALID_SIZE if the message
+ *         alone exceeds the budget
+ */
+esp_err_t mqtt_outbox_push(const char *topic, const void *data, size_t len, int qos, int retain);
+
+/**
+ * @brief Look at the oldest queued message
+ * 
+ * @param msg Output: message, valid until the next push or pop
+ * @return true if there is one
+ */
+bool mqtt_outbox_peek(mqtt_outbox_msg_t *msg);
+
+/**
+ * @brief Remove the oldest queued message once it has been handed on
+ */
+void mqtt_outbox_pop(void);
+
+/**
+ * @brief Get the outbox counters
+ * 
+ * @param stats Output: counters since init
+ */
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats);
+
+#endif // MQTT_OUTBOX_H
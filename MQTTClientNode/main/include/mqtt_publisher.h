@@ -2,16 +2,101 @@
 #define MQTT_PUBLISHER_H
 
 #include "esp_err.h"
+#include <stdint.h>
+
+/**
+ * @brief Telemetry payload encoding
+ * 
+ * JSON goes to CONFIG_MQTT_TOPIC. CBOR goes to CONFIG_MQTT_CBOR_TOPIC, whose
+ * last level is the client ID. Both layouts are described in telemetry.h.
+ */
+typedef enum {
+    MQTT_PAYLOAD_JSON = 0,
+    MQTT_PAYLOAD_CBOR = 1,
+    MQTT_PAYLOAD_BOTH = 2     // Publish both, e.g. while migrating consumers
+} mqtt_payload_format_t;
+
+/**
+ * @brief Publisher counters since boot
+ */
+typedef struct {
+    uint32_t samples;       // Samples taken
+    uint32_t admitted;      // Samples accepted for publishing (changed, heartbeat, or deadband off)
+    uint32_t suppressed;    // Samples within every deadband, not published
+    uint32_t heartbeats;    // Admitted only because the heartbeat interval expired
+    uint32_t published;     // Samples delivered to the MQTT client
+    uint32_t messages;      // MQTT messages those samples were sent in
+    uint32_t dropped;       // Samples lost because the queue was full while offline
+    uint32_t stored;        // Samples written to the offline store while disconnected
+    uint32_t replayed;      // Stored samples published after reconnecting
+    uint32_t coalesced;     // Samples overwritten by a newer one while publishing was stretched
+    uint32_t downgraded;    // Messages sent at QoS 0 because the in-flight window was full
+    uint32_t stretch;       // Current publish interval multiplier (1 = no backpressure)
+} mqtt_publisher_stats_t;
 
 /**
  * @brief Read all sensors and publish data via MQTT
  * 
- * Reads DHT11 and hygrometer sensors (respecting minimum intervals),
- * builds a JSON payload with all sensor data and timestamp,
- * and publishes to the configured MQTT topic.
+ * Takes the latest DHT11 and hygrometer readings from the sampling tasks
+ * (see sensor_sampler.h, never waits on sensor hardware), encodes all sensor data and timestamp in the active payload format,
+ * and publishes to the configured MQTT topic(s).
+ * 
+ * With CONFIG_MQTT_BATCH_SIZE > 1 the sample is queued instead, and the
+ * queue goes out as one array payload once it holds CONFIG_MQTT_BATCH_SIZE
+ * samples or its oldest sample is CONFIG_MQTT_BATCH_MAX_LATENCY_MS old.
+ * Samples keep queueing while MQTT is disconnected (oldest dropped when full).
  * 
- * @return ESP_OK on success, error code otherwise
+ * With the offline store open, samples taken while MQTT is disconnected go to
+ * flash instead and are replayed after reconnect, at most
+ * CONFIG_OFFLINE_STORE_DRAIN_PER_CYCLE per call, after the live samples.
+ * 
+ * Under MQTT backpressure (see mqtt_manager_get_pressure()) the publisher
+ * backs off instead of growing the esp-mqtt outbox: at
+ * CONFIG_MQTT_BACKPRESSURE_HIGH_PCT it flushes only every 2, 4, ... cycles
+ * (samples in between coalesce in the batch) and pauses the offline replay;
+ * with the outbox full it publishes at QoS 0 (CONFIG_MQTT_BACKPRESSURE_QOS0)
+ * or holds the samples.
+ * 
+ * With CONFIG_MQTT_DEADBAND_ENABLED, samples whose metrics all stay within
+ * their deadbands are suppressed, except once per CONFIG_MQTT_HEARTBEAT_MS.
+ * 
+ * @return ESP_OK on success (including a sample only queued), error code otherwise
  */
 esp_err_t mqtt_publish_sensor_data(void);
 
+/**
+ * @brief Publish all queued samples now, regardless of the batch limits
+ * 
+ * While disconnected, queued samples are moved to the offline store and its
+ * staged records are written to flash, so nothing is lost across a restart.
+ * 
+ * @return ESP_OK on success (or nothing queued), ESP_ERR_INVALID_STATE if MQTT
+ *         is not connected and there is no offline store, error code otherwise
+ */
+esp_err_t mqtt_publisher_flush(void);
+
+/**
+ * @brief Get publisher counters (samples sent, suppressed, dropped, ...)
+ * 
+ * @param stats Output: counters since boot
+ */
+void mqtt_publisher_get_stats(mqtt_publisher_stats_t *stats);
+
+/**
+ * @brief Select the telemetry payload format used from the next publish on
+ * 
+ * With both formats, samples count as published once their JSON message is
+ * accepted; the CBOR copy is best effort and never causes a JSON resend.
+ * 
+ * @param format JSON, CBOR, or both
+ */
+void mqtt_publisher_set_format(mqtt_payload_format_t format);
+
+/**
+ * @brief Get the active telemetry payload format
+ * 
+ * @return mqtt_payload_format_t Active format
+ */
+mqtt_payload_format_t mqtt_publisher_get_format(void);
+
 #endif // MQTT_PUBLISHER_H
@@ -0,0 +1,55 @@
+#ifndef MQTT_TLS_H
+#define MQTT_TLS_H
+
+#include "esp_transport.h"
+#include <stdint.h>
+
+/**
+ * @brief TLS handshake counters
+ * 
+ * A handshake counts as resumed when a cached session was offered; a broker
+ * that declines it falls back to a full handshake inside the same call, which
+ * shows up as resumed handshakes as slow as full ones (compare the tls_full
+ * and tls_resumed latency stages).
+ */
+typedef struct {
+    uint32_t full;              // Handshakes without a cached session
+    uint32_t resumed;           // Handshakes offering the cached session
+    uint32_t failures;          // Failed connects (a TLS-level failure drops the cached session)
+    uint32_t full_heap_peak;    // Most heap drawn by a full handshake (bytes, see below)
+    uint32_t resumed_heap_peak; // Most heap drawn by a resumed handshake (bytes)
+    uint32_t session_cached;    // 1 while a session is cached for the next connect
+} mqtt_tls_stats_t;
+
+/**
+ * @brief Create the TLS transport for esp-mqtt (esp_mqtt_client_config_t.network.transport)
+ * 
+ * A minimal esp_transport over esp-tls that keeps the TLS session (ticket
+ * or session ID, see CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS) when a
+ * connection closes and offers it on the next connect, so a reconnect costs
+ * an abbreviated handshake instead of a full one with certificate
+ * verification. The session is only offered to the host:port that issued
+ * it, and is only dropped when a handshake fails in the TLS layer, not when
+ * the broker cannot be reached. It is kept in RAM only and is lost on reset.
+ * 
+ * Each handshake is timed into the LATENCY_STAGE_TLS_FULL or
+ * LATENCY_STAGE_TLS_RESUMED stage. Heap drawn is the free heap before the
+ * handshake minus the lowest free heap during it (heap_caps local minimum
+ * monitor); it includes allocations other tasks make meanwhile.
+ * 
+ * The server certificate is checked against CONFIG_MQTT_TLS_CA_PEM, or the
+ * ESP x509 certificate bundle if it is NULL. esp-mqtt owns the returned
+ * transport and destroys it with the client.
+ * 
+ * @return esp_transport_handle_t Transport, NULL if out of memory
+ */
+esp_transport_handle_t mqtt_tls_transport_create(void);
+
+/**
+ * @brief Get the TLS handshake counters
+ * 
+ * @param stats Output: counters since boot
+ */
+void mqtt_tls_get_stats(mqtt_tls_stats_t *stats);
+
+#endif // MQTT_TLS_H
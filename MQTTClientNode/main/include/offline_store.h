@@ -0,0 +1,96 @@
+#ifndef OFFLINE_STORE_H
+#define OFFLINE_STORE_H
+
+#include "esp_err.h"
+#include "telemetry.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Offline store counters since boot
+ */
+typedef struct {
+    uint32_t pending;         // Unpublished samples on flash (plus staged in RAM)
+    uint32_t appended;        // Samples stored
+    uint32_t drained;         // Samples published from the store
+    uint32_t overwritten;     // Unpublished samples lost when the ring wrapped
+    uint32_t sector_erases;   // Sector erases (one per sector per trip around the ring)
+    uint32_t write_errors;    // Failed flash operations
+} offline_store_stats_t;
+
+/**
+ * @brief Open the offline store and recover its state from flash
+ * 
+ * The store is an append-only ring of fixed-size sample records on the
+ * CONFIG_OFFLINE_STORE_PARTITION data partition. Records are written in
+ * order, a sector is only erased when the ring wraps onto it (even wear),
+ * and a published record is marked by programming its consumed flag from
+ * 0xFF to 0x00 in place, which needs no erase. Unpublished records survive
+ * reboots: the state is rebuilt by scanning the record headers.
+ * 
+ * @return esp_err_t ESP_OK if successful, ESP_ERR_NOT_FOUND if the partition is missing
+ */
+esp_err_t offline_store_init(void);
+
+/**
+ * @brief Check whether the store is open
+ * 
+ * @return true if samples can be appended
+ */
+bool offline_store_ready(void);
+
+/**
+ * @brief Append a sample
+ * 
+ * Samples are staged in RAM and programmed CONFIG_OFFLINE_STORE_WRITE_BATCH
+ * records at a time; up to that many samples are lost on a power cut.
+ * When the ring is full, the oldest sector is erased and its samples dropped.
+ * 
+ * @param sample Sample to store
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t offline_store_append(const telemetry_sample_t *sample);
+
+/**
+ * @brief Program all staged samples to flash
+ * 
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t offline_store_flush(void);
+
+/**
+ * @brief Number of samples waiting to be published
+ * 
+ * @return uint32_t Pending samples, staged ones included
+ */
+uint32_t offline_store_pending(void);
+
+/**
+ * @brief Read the oldest unpublished samples without removing them
+ * 
+ * Staged samples are flushed first so they are included.
+ * 
+ * @param samples Output: samples, oldest first
+ * @param max_samples Capacity of samples
+ * @param num_samples Output: number of samples read
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t offline_store_peek(telemetry_sample_t *samples, size_t max_samples, size_t *num_samples);
+
+/**
+ * @brief Mark the oldest count unpublished samples as published
+ * 
+ * @param count Number of samples to consume (as returned by offline_store_peek())
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t offline_store_consume(size_t count);
+
+/**
+ * @brief Get offline store counters
+ * 
+ * @param stats Output: counters since boot
+ */
+void offline_store_get_stats(offline_store_stats_t *stats);
+
+#endif // OFFLINE_STORE_H
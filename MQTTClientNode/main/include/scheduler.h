@@ -0,0 +1,84 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Periodic job body, called once per period from the job's own task
+ */
+typedef void (*scheduler_job_fn_t)(void *arg);
+
+/**
+ * @brief Periodic job description
+ */
+typedef struct {
+    const char *name;           // Task and log name
+    scheduler_job_fn_t fn;      // Job body
+    void *arg;                  // Passed to fn
+    uint32_t period_ms;         // Period between deadlines
+    uint32_t phase_ms;          // Offset of the deadlines from the shared time grid (< period_ms)
+    uint32_t stack_size;        // Job task stack (bytes)
+    uint32_t priority;          // Job task priority
+} scheduler_job_config_t;
+
+/**
+ * @brief Per-job timing counters since the job was added
+ */
+typedef struct {
+    uint32_t runs;              // Completed runs
+    uint32_t missed;            // Deadlines skipped because the previous run overran them
+    int64_t last_jitter_us;     // Start delay of the last run past its deadline
+    int64_t max_jitter_us;      // Worst start delay
+    int64_t total_jitter_us;    // Sum of start delays (mean = total / runs)
+    int64_t last_runtime_us;    // Duration of the last run
+    int64_t max_runtime_us;     // Longest run
+} scheduler_job_stats_t;
+
+/**
+ * @brief Add a periodic job, running on its own task
+ * 
+ * Deadlines are absolute esp_timer times, phase_ms + k * period_ms from
+ * boot, so execution time never accumulates into drift and jobs on the same
+ * grid keep their relative phase (give slow jobs different phases so they
+ * do not start together). A one-shot esp_timer wakes the job task at each
+ * deadline. When a run overruns one or more later deadlines, those are
+ * counted as missed and skipped rather than run back to back.
+ * 
+ * @param config Job description (copied)
+ * @param job_id Output (optional): ID for scheduler_get_stats()
+ * @return esp_err_t ESP_OK if successful, ESP_ERR_NO_MEM if the job table is full
+ */
+esp_err_t scheduler_add_job(const scheduler_job_config_t *config, int *job_id);
+
+/**
+ * @brief Get the timing counters of a job
+ * 
+ * @param job_id ID returned by scheduler_add_job()
+ * @param stats Output: counters
+ * @return esp_err_t ESP_OK if successful, ESP_ERR_INVALID_ARG if the ID is unknown
+ */
+esp_err_t scheduler_get_stats(int job_id, scheduler_job_stats_t *stats);
+
+/**
+ * @brief Number of jobs added so far (IDs are 0 .. count - 1)
+ * 
+ * @return size_t Job count
+ */
+size_t scheduler_get_job_count(void);
+
+/**
+ * @brief Get the name of a job
+ * 
+ * @param job_id Job ID
+ * @return const char* Name, NULL if the ID is unknown
+ */
+const char *scheduler_get_job_name(int job_id);
+
+/**
+ * @brief Log the timing counters of every job
+ */
+void scheduler_log_stats(void);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,47 @@
+#ifndef SENSOR_SAMPLER_H
+#define SENSOR_SAMPLER_H
+
+#include "esp_err.h"
+#include "dht11_manager.h"
+#include "hygrometer_manager.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Start the sensor sampling tasks
+ * 
+ * Each sensor family gets its own scheduler job, and so its own task, with
+ * its own period and phase (CONFIG_DHT11_READ_INTERVAL,
+ * CONFIG_HYGROMETER_READ_INTERVAL, CONFIG_*_SAMPLE_PHASE_MS). A job
+ * talks to the hardware, then publishes the readings into a latest-value
+ * snapshot guarded by a seqlock, so a slow or failing sensor never delays
+ * the publisher and readers never wait on a lock. Families without
+ * sensors get no job.
+ * 
+ * Call after the DHT11 and hygrometer managers are initialized.
+ * 
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t sensor_sampler_start(void);
+
+/**
+ * @brief Copy the latest DHT11 readings (never blocks on hardware)
+ * 
+ * @param data Output: one reading per sensor
+ * @param max_sensors Capacity of data
+ * @param updated_us Output (optional): esp_timer time of the readings, 0 if never sampled
+ * @return size_t Number of sensors copied
+ */
+size_t sensor_sampler_get_dht11(dht11_data_t *data, size_t max_sensors, int64_t *updated_us);
+
+/**
+ * @brief Copy the latest hygrometer readings (never blocks on hardware)
+ * 
+ * @param data Output: one reading per probe
+ * @param max_probes Capacity of data
+ * @param updated_us Output (optional): esp_timer time of the readings, 0 if never sampled
+ * @return size_t Number of probes copied
+ */
+size_t sensor_sampler_get_hygrometer(hygrometer_data_t *data, size_t max_probes, int64_t *updated_us);
+
+#endif // SENSOR_SAMPLER_H
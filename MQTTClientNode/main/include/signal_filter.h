@@ -0,0 +1,88 @@
+#ifndef SIGNAL_FILTER_H
+#define SIGNAL_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIGNAL_FILTER_WINDOW  7   // Median / Hampel window (odd, small: per-sample cost is O(window))
+
+/**
+ * @brief Running median over the last SIGNAL_FILTER_WINDOW samples
+ * 
+ * Keeps the window both in arrival order and sorted, so each update is one
+ * removal and one insertion into a fixed-size array.
+ */
+typedef struct {
+    int32_t window[SIGNAL_FILTER_WINDOW];  // Samples in arrival order (ring)
+    int32_t sorted[SIGNAL_FILTER_WINDOW];  // Same samples, ascending
+    uint8_t pos;                           // Next ring position
+    uint8_t count;                         // Valid samples
+} signal_median_t;
+
+/**
+ * @brief Exponential IIR low-pass in fixed point (alpha = 1 / 2^shift)
+ */
+typedef struct {
+    int32_t state_q8;   // Filter state, 8 fractional bits
+    uint8_t shift;      // Smoothing: time constant of ~2^shift samples
+    bool primed;        // First sample loads the state directly
+} signal_ema_t;
+
+/**
+ * @brief Hampel outlier rejection on top of a running median
+ * 
+ * A sample further than k * 1.4826 * MAD (median absolute deviation) from the
+ * window median is replaced by the median. min_threshold keeps quantized
+ * signals (MAD of 0 or 1 code) from rejecting ordinary noise.
+ */
+typedef struct {
+    signal_median_t median;
+    uint16_t k_x10;           // Threshold in tenths of a sigma (30 = 3 sigma)
+    int32_t min_threshold;    // Smallest deviation ever rejected
+    uint32_t rejected;        // Samples replaced so far
+} signal_hampel_t;
+
+/**
+ * @brief Filter pipeline for an analog channel: Hampel rejection, then EMA
+ */
+typedef struct {
+    signal_hampel_t hampel;
+    signal_ema_t ema;
+} signal_filter_t;
+
+void signal_median_init(signal_median_t *m);
+int32_t signal_median_update(signal_median_t *m, int32_t sample);
+int32_t signal_median_get(const signal_median_t *m);
+
+void signal_ema_init(signal_ema_t *e, uint8_t shift);
+int32_t signal_ema_update(signal_ema_t *e, int32_t sample);
+
+void signal_hampel_init(signal_hampel_t *h, uint16_t k_x10, int32_t min_threshold);
+int32_t signal_hampel_update(signal_hampel_t *h, int32_t sample);
+
+/**
+ * @brief Initialize a Hampel + EMA pipeline
+ * 
+ * @param f Filter to initialize
+ * @param ema_shift EMA smoothing (time constant ~2^shift samples)
+ * @param k_x10 Hampel threshold in tenths of a sigma
+ * @param min_threshold Smallest deviation the Hampel stage rejects
+ */
+void signal_filter_init(signal_filter_t *f, uint8_t ema_shift, uint16_t k_x10, int32_t min_threshold);
+
+/**
+ * @brief Feed one sample through the pipeline
+ * 
+ * The EMA starts once the Hampel window is full, seeded with the window
+ * median, so a spike among the first samples cannot bias the output.
+ * 
+ * @return int32_t Filtered output after this sample
+ */
+int32_t signal_filter_update(signal_filter_t *f, int32_t sample);
+
+/**
+ * @brief Current filtered output (0 until SIGNAL_FILTER_WINDOW samples were fed)
+ */
+int32_t signal_filter_get(const signal_filter_t *f);
+
+#endif // SIGNAL_FILTER_H
@@ -10,6 +10,13 @@
  */
 esp_err_t init_nvs(void);
 
+/**
+ * @brief Initialize the flash-backed offline store (needs the partition table)
+ * 
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t init_offline_store(void);
+
 /**
  * @brief Initialize logging system with configured levels
  * 
@@ -77,6 +84,13 @@ esp_err_t init_adc_scanner(void);
  */
 esp_err_t init_hygrometer(void);
 
+/**
+ * @brief Start the sensor sampling tasks (after the sensor managers)
+ * 
+ * @return esp_err_t ESP_OK if successful
+ */
+esp_err_t init_sensor_sampler(void);
+
 /**
  * @brief Fatal halt: log reason and stop main task forever
  * 
@@ -0,0 +1,104 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "config.h"
+#include "dht11_manager.h"
+#include "hygrometer_manager.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One telemetry sample: every sensor reading at one point in time
+ * 
+ * Readings are stored as fixed-point integers so a sample is small enough to
+ * queue in RAM (batching) and cheap to encode. Sensor GPIOs are not stored;
+ * they are static per node and looked up from the managers when encoding.
+ */
+typedef struct {
+    int64_t timestamp_ms;                                   // Milliseconds since the Unix epoch
+    uint8_t dht11_count;                                    // DHT11 sensors in this sample
+    uint8_t hygro_count;                                    // Hygrometer probes in this sample
+    uint8_t dht11_valid;                                    // Bit i: DHT11 sensor i has a reading
+    uint8_t hygro_valid;                                    // Bit i: probe i has a reading
+    int16_t temperature_x10[CONFIG_DHT11_MAX_SENSORS];      // Tenths of a degree C
+    int16_t humidity_x10[CONFIG_DHT11_MAX_SENSORS];         // Tenths of a percent
+    uint16_t moisture_x100[CONFIG_HYGROMETER_MAX_PROBES];   // Hundredths of a percent
+} telemetry_sample_t;
+
+/**
+ * @brief Fill a sample from sensor readings
+ * 
+ * @param sample Sample to fill
+ * @param timestamp_ms Capture time, milliseconds since the Unix epoch
+ * @param dht11 DHT11 readings, one per sensor
+ * @param dht11_count Number of DHT11 readings
+ * @param hygro Hygrometer readings, one per probe
+ * @param hygro_count Number of hygrometer readings
+ */
+void telemetry_sample_fill(telemetry_sample_t *sample, int64_t timestamp_ms,
+                           const dht11_data_t *dht11, size_t dht11_count,
+                           const hygrometer_data_t *hygro, size_t hygro_count);
+
+/**
+ * @brief Check whether a sample differs meaningfully from a reference sample
+ * 
+ * Each metric has its own deadband (CONFIG_MQTT_DEADBAND_*): the sample counts
+ * as changed if any metric moved by more than its threshold, or a sensor
+ * gained or lost its reading, or the sensor count changed.
+ * 
+ * @param sample New sample
+ * @param reference Last sample that was sent
+ * @return true if the sample should be sent
+ */
+bool telemetry_sample_exceeds_deadband(const telemetry_sample_t *sample,
+                                       const telemetry_sample_t *reference);
+
+/**
+ * @brief Encode samples as JSON into buf (no heap allocation)
+ * 
+ * A single sample keeps the original flat object:
+ *   {"client_id", "ip", "timestamp", "temperature_c", "humidity_pct",
+ *    "moisture_pct", ["dht11": [...]], ["hygrometer": [...]]}
+ * Several samples are sent as one batch, each sample holding the per-sample
+ * fields of the flat object:
+ *   {"client_id", "ip", "samples": [{"timestamp", "temperature_c", ...}, ...]}
+ * 
+ * @param buf Output buffer (NUL-terminated on success)
+ * @param buf_size Size of buf
+ * @param client_id Client ID
+ * @param ip Local IP address as text
+ * @param samples Samples, oldest first
+ * @param count Number of samples (>= 1)
+ * @return size_t Payload length, 0 if it does not fit
+ */
+size_t telemetry_encode_json(char *buf, size_t buf_size, const char *client_id, const char *ip,
+                             const telemetry_sample_t *samples, size_t count);
+
+/**
+ * @brief Encode samples as CBOR with integer keys into buf (no heap allocation)
+ * 
+ * A single sample is a map with these keys:
+ * 
+ *   0: schema version (uint, currently 1)
+ *   1: timestamp, milliseconds since the Unix epoch (uint)
+ *   2: IPv4 address (4-byte string, network order)
+ *   3: temperature of the first DHT11 in tenths of a degree C (int or null)
+ *   4: humidity of the first DHT11 in tenths of a percent (int or null)
+ *   5: moisture of the first probe in hundredths of a percent (uint or null)
+ *   6: multi-sensor nodes only: array of [gpio, temperature, humidity]
+ *   7: multi-probe nodes only: array of [gpio, moisture]
+ * 
+ * A batch is a map of keys 0, 2 and 8: array of per-sample maps (keys 1, 3-7).
+ * 
+ * @param buf Output buffer
+ * @param buf_size Size of buf
+ * @param ip4 Local IPv4 address, network order
+ * @param samples Samples, oldest first
+ * @param count Number of samples (>= 1)
+ * @return size_t Payload length, 0 if it does not fit
+ */
+size_t telemetry_encode_cbor(uint8_t *buf, size_t buf_size, uint32_t ip4,
+                             const telemetry_sample_t *samples, size_t count);
+
+#endif // TELEMETRY_H
@@ -5,9 +5,49 @@
 #include "config.h"
 #include "system_init.h"
 #include "mqtt_publisher.h"
+#include "adc_scanner.h"
+#include "scheduler.h"
+#include "diagnostics.h"
+#include "mqtt_manager.h"
 
 static const char *TAG = "ESP32_MQTT";
 
+#define PUBLISH_TASK_STACK      4096
+#define PUBLISH_TASK_PRIORITY   3
+#define PRESENCE_TASK_STACK     4096
+#define PRESENCE_TASK_PRIORITY  2
+#define STATS_TASK_STACK        3072
+#define STATS_TASK_PRIORITY     1
+#define DIAG_TASK_STACK         3072
+#define DIAG_TASK_PRIORITY      1
+#define PROBE_TASK_STACK        4096
+#define PROBE_TASK_PRIORITY     1
+
+static void publish_job(void *arg)
+{
+    mqtt_publish_sensor_data();
+}
+
+static void presence_job(void *arg)
+{
+    adc_scanner_check_presence();
+}
+
+static void stats_job(void *arg)
+{
+    scheduler_log_stats();
+}
+
+static void diagnostics_job(void *arg)
+{
+    diagnostics_publish();
+}
+
+static void broker_probe_job(void *arg)
+{
+    mqtt_manager_check_brokers();
+}
+
 void app_main(void)
 {
     // Initialize entire system
@@ -15,29 +55,69 @@ void app_main(void)
         fatal_halt("System initialization failed");
     }
 
-    // // Initialize ADC scanner
+    // One-time report of all ADC1 channels to help locate analog sensors
+    adc_scan_result_t scan_results[8];
+    size_t num_results = 0;
+    adc_scanner_scan(scan_results, &num_results, 8);
 
     // Wait a moment for MQTT to connect
     vTaskDelay(pdMS_TO_TICKS(CONFIG_STARTUP_DELAY));
 
-    // Main loop: publish sensor data periodically
-    while (true) {
-        mqtt_publish_sensor_data();
-        vTaskDelay(pdMS_TO_TICKS(CONFIG_PUBLISH_INTERVAL));
+    // Periodic work runs as scheduler jobs on absolute deadlines, so neither
+    // the publish time nor a slow sweep adds to the period
+    const scheduler_job_config_t jobs[] = {
+        {
+            .name = "publish",
+            .fn = publish_job,
+            .period_ms = CONFIG_PUBLISH_INTERVAL,
+            .phase_ms = CONFIG_PUBLISH_PHASE_MS,
+            .stack_size = PUBLISH_TASK_STACK,
+            .priority = PUBLISH_TASK_PRIORITY,
+        },
+        {
+            // Periodic sensor-presence sweep (one interleaved pass over all channels)
+            .name = "adc_presence",
+            .fn = presence_job,
+            .period_ms = CONFIG_ADC_SCAN_INTERVAL,
+            .phase_ms = CONFIG_ADC_SCAN_PHASE_MS,
+            .stack_size = PRESENCE_TASK_STACK,
+            .priority = PRESENCE_TASK_PRIORITY,
+        },
+        {
+            .name = "sched_stats",
+            .fn = stats_job,
+            .period_ms = CONFIG_SCHEDULER_STATS_INTERVAL,
+            .phase_ms = 0,
+            .stack_size = STATS_TASK_STACK,
+            .priority = STATS_TASK_PRIORITY,
+        },
+        {
+            .name = "diagnostics",
+            .fn = diagnostics_job,
+            .period_ms = CONFIG_DIAG_INTERVAL,
+            .phase_ms = CONFIG_DIAG_PHASE_MS,
+            .stack_size = DIAG_TASK_STACK,
+            .priority = DIAG_TASK_PRIORITY,
+        },
+        {
+            // Broker health probes and fail-back (idle with a single broker)
+            .name = "broker_probe",
+            .fn = broker_probe_job,
+            .period_ms = CONFIG_MQTT_BROKER_PROBE_INTERVAL,
+            .phase_ms = CONFIG_MQTT_BROKER_PROBE_PHASE_MS,
+            .stack_size = PROBE_TASK_STACK,
+            .priority = PROBE_TASK_PRIORITY,
+        },
+    };
+
+    for (size_t i = 0; i < sizeof(jobs) / sizeof(jobs[0]); i++) {
+        if (jobs[i].period_ms == 0) {
+            continue;  // Disabled in configuration
+        }
+        if (scheduler_add_job(&jobs[i], NULL) != ESP_OK) {
+            fatal_halt("Failed to schedule periodic jobs");
+        }
     }
-}
 
-    // if (init_adc_scanner() != ESP_OK) {
-    //     ESP_LOGW(TAG, "ADC scanner init failed");
-    // } else {
-    //     // Run a one-time scan to detect hygrometer GPIO
-    //     ESP_LOGI(TAG, "Scanning ADC channels to detect hygrometer...");
-    //     adc_scan_result_t scan_results[8];
-    //     size_t num_results = 0;
-        
-    //     if (adc_scanner_scan(scan_results, &num_results, 8) == ESP_OK) {
-    //         ESP_LOGI(TAG, "ADC scan completed. Check results above.");
-    //     } else {
-    //         ESP_LOGW(TAG, "ADC scan failed");
-    //     }
-    // }
\ No newline at end of file
+    ESP_LOGI(TAG, "Periodic jobs running, main task done");
+}
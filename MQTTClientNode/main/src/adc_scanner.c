@@ -1,10 +1,14 @@
 #include "adc_scanner.h"
+#include "config.h"
+#include "signal_filter.h"
 #include "esp_log.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "ADC_SCANNER";
@@ -13,6 +17,14 @@ static const char *TAG = "ADC_SCANNER";
 static adc_oneshot_unit_handle_t adc1_handle = NULL;
 static adc_cali_handle_t adc1_cali_handle = NULL;
 
+// Serializes every use of ADC1: engine start/stop and all reads. The
+// presence sweep and the hygrometer read from different tasks, and one must
+// not convert or read the rings while the other tears the engine down.
+static SemaphoreHandle_t adc1_lock = NULL;
+
+// Raw code -> millivolts, built once from the active calibration scheme
+static uint16_t adc1_mv_lut[ADC_SCANNER_RAW_CODES];
+
 // ADC1 GPIO to channel mapping for commonly available pins
 typedef struct {
     int gpio;
@@ -30,16 +42,90 @@ static const adc_gpio_map_t adc1_gpio_map[] = {
 
 #define ADC1_GPIO_COUNT (sizeof(adc1_gpio_map) / sizeof(adc1_gpio_map[0]))
 
-// Get channel for GPIO
-static esp_err_t get_adc_channel(int gpio_num, adc_channel_t *channel)
+// Streaming Hampel + EMA filter per ADC1 channel (same order as adc1_gpio_map).
+// Fed by the drain task while continuous sampling runs, by one-shot reads otherwise.
+static signal_filter_t adc1_filters[ADC1_GPIO_COUNT];
+
+// Continuous (DMA) sampling engine
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define ADC_CONT_OUTPUT_FORMAT    ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ADC_CONT_GET_CHANNEL(p)   ((p)->type1.channel)
+#define ADC_CONT_GET_DATA(p)      ((p)->type1.data)
+#else
+#define ADC_CONT_OUTPUT_FORMAT    ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ADC_CONT_GET_CHANNEL(p)   ((p)->type2.channel)
+#define ADC_CONT_GET_DATA(p)      ((p)->type2.data)
+#endif
+
+#define ADC_CONT_RING_MASK        (CONFIG_ADC_CONTINUOUS_RING_SAMPLES - 1)
+#define ADC_CONT_TASK_STACK       3072
+#define ADC_CONT_TASK_PRIORITY    5
+
+// Scan constants
+#define ADC_SCAN_NUM_SAMPLES      64     // Samples averaged per channel
+#define ADC_SCAN_BURST_TIMEOUT_MS 100    // One 6-channel burst needs ~20ms of conversions plus a DMA frame
+
+_Static_assert((CONFIG_ADC_CONTINUOUS_RING_SAMPLES & ADC_CONT_RING_MASK) == 0,
+               "CONFIG_ADC_CONTINUOUS_RING_SAMPLES must be a power of two");
+
+// Most recent samples of one channel in the conversion pattern
+typedef struct {
+    int gpio;
+    adc_channel_t channel;
+    uint32_t head;      // Next write position
+    uint32_t count;     // Valid samples (saturates at the ring size)
+    signal_filter_t *filter;
+    uint16_t ring[CONFIG_ADC_CONTINUOUS_RING_SAMPLES];
+} adc_cont_channel_t;
+
+static struct {
+    adc_continuous_handle_t handle;
+    TaskHandle_t task;
+    SemaphoreHandle_t task_exited;  // Given by the drain task right before it deletes itself
+    volatile bool stop_requested;
+    portMUX_TYPE lock;
+    size_t num_channels;
+    int8_t slot_of_channel[SOC_ADC_MAX_CHANNEL_NUM];  // ADC channel -> index in channels[], -1 if unused
+    adc_cont_channel_t channels[ADC1_GPIO_COUNT];
+    uint8_t frame[CONFIG_ADC_CONTINUOUS_FRAME_BYTES];
+} adc_cont = {
+    .handle = NULL,
+    .task = NULL,
+    .task_exited = NULL,
+    .stop_requested = false,
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+    .num_channels = 0
+};
+
+// Get index in adc1_gpio_map for GPIO (-1 if not an ADC1 pin)
+static int get_adc_map_index(int gpio_num)
 {
     for (int i = 0; i < ADC1_GPIO_COUNT; i++) {
         if (adc1_gpio_map[i].gpio == gpio_num) {
-            *channel = adc1_gpio_map[i].channel;
-            return ESP_OK;
+            return i;
         }
     }
-    return ESP_ERR_NOT_FOUND;
+    return -1;
+}
+
+// Get channel for GPIO
+static esp_err_t get_adc_channel(int gpio_num, adc_channel_t *channel)
+{
+    int idx = get_adc_map_index(gpio_num);
+    if (idx < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *channel = adc1_gpio_map[idx].channel;
+    return ESP_OK;
+}
+
+// Restart every channel filter from an empty window
+static void adc_filters_reset(void)
+{
+    for (int i = 0; i < ADC1_GPIO_COUNT; i++) {
+        signal_filter_init(&adc1_filters[i], CONFIG_ADC_FILTER_EMA_SHIFT,
+                           CONFIG_ADC_FILTER_HAMPEL_K_X10, CONFIG_ADC_FILTER_MIN_THRESHOLD);
+    }
 }
 
 // Initialize ADC calibration
@@ -88,6 +174,280 @@ static bool adc_calibration_init(adc_unit_t unit, adc_atten_t atten, adc_cali_ha
     return calibrated;
 }
 
+// Precompute the millivolt value of every raw code
+static void adc_build_mv_lut(void)
+{
+    for (int raw = 0; raw < ADC_SCANNER_RAW_CODES; raw++) {
+        int voltage;
+        if (!adc1_cali_handle || adc_cali_raw_to_voltage(adc1_cali_handle, raw, &voltage) != ESP_OK) {
+            // No calibration: linear approximation (3.3V = 4095 for 12-bit)
+            voltage = (raw * 3300) / 4095;
+        }
+        adc1_mv_lut[raw] = (uint16_t)voltage;
+    }
+}
+
+// Convert a raw reading to millivolts (single table load)
+static inline int adc_raw_to_mv(int raw)
+{
+    if (raw < 0) {
+        raw = 0;
+    } else if (raw >= ADC_SCANNER_RAW_CODES) {
+        raw = ADC_SCANNER_RAW_CODES - 1;
+    }
+    return adc1_mv_lut[raw];
+}
+
+// DMA frame ready (ISR context): wake the drain task
+static bool IRAM_ATTR adc_cont_on_conv_done(adc_continuous_handle_t handle,
+                                            const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    BaseType_t higher_prio_woken = pdFALSE;
+    TaskHandle_t task = adc_cont.task;
+    if (task) {
+        vTaskNotifyGiveFromISR(task, &higher_prio_woken);
+    }
+    return higher_prio_woken == pdTRUE;
+}
+
+// Drain DMA frames and de-interleave samples into the per-channel rings
+static void adc_cont_task(void *arg)
+{
+    while (!adc_cont.stop_requested) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t len = 0;
+        while (!adc_cont.stop_requested &&
+               adc_continuous_read(adc_cont.handle, adc_cont.frame, sizeof(adc_cont.frame), &len, 0) == ESP_OK) {
+            portENTER_CRITICAL(&adc_cont.lock);
+            for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                adc_digi_output_data_t *p = (adc_digi_output_data_t *)&adc_cont.frame[i];
+                uint32_t chan = ADC_CONT_GET_CHANNEL(p);
+                if (chan >= SOC_ADC_MAX_CHANNEL_NUM || adc_cont.slot_of_channel[chan] < 0) {
+                    continue;
+                }
+                adc_cont_channel_t *c = &adc_cont.channels[adc_cont.slot_of_channel[chan]];
+                c->ring[c->head] = (uint16_t)ADC_CONT_GET_DATA(p);
+                c->head = (c->head + 1) & ADC_CONT_RING_MASK;
+                if (c->count < CONFIG_ADC_CONTINUOUS_RING_SAMPLES) {
+                    c->count++;
+                }
+            }
+            portEXIT_CRITICAL(&adc_cont.lock);
+
+            // Filter outside the spinlock: only this task updates the filters
+            // while the engine runs, and readers just load the output
+            for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                adc_digi_output_data_t *p = (adc_digi_output_data_t *)&adc_cont.frame[i];
+                uint32_t chan = ADC_CONT_GET_CHANNEL(p);
+                if (chan >= SOC_ADC_MAX_CHANNEL_NUM || adc_cont.slot_of_channel[chan] < 0) {
+                    continue;
+                }
+                signal_filter_update(adc_cont.channels[adc_cont.slot_of_channel[chan]].filter,
+                                     (int32_t)ADC_CONT_GET_DATA(p));
+            }
+        }
+    }
+
+    // Last access to the engine is behind us: the handle may be freed now
+    xSemaphoreGive(adc_cont.task_exited);
+    vTaskDelete(NULL);
+}
+
+// Stop the drain task and wait until it is out of adc_continuous_read()
+static void adc_cont_task_join(void)
+{
+    if (adc_cont.task == NULL) {
+        return;
+    }
+    adc_cont.stop_requested = true;
+    xTaskNotifyGive(adc_cont.task);
+    xSemaphoreTake(adc_cont.task_exited, portMAX_DELAY);
+    adc_cont.task = NULL;
+}
+
+// Average the most recent samples of a channel held in the continuous rings
+static esp_err_t adc_cont_read_average(int gpio_num, int num_samples, int *raw_avg)
+{
+    adc_cont_channel_t *c = NULL;
+    for (size_t i = 0; i < adc_cont.num_channels; i++) {
+        if (adc_cont.channels[i].gpio == gpio_num) {
+            c = &adc_cont.channels[i];
+            break;
+        }
+    }
+    if (c == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;  // ADC1 is owned by the DMA engine, one-shot reads are blocked
+    }
+
+    uint32_t sum = 0;
+    uint32_t n = 0;
+    portENTER_CRITICAL(&adc_cont.lock);
+    n = (uint32_t)num_samples < c->count ? (uint32_t)num_samples : c->count;
+    uint32_t idx = c->head;
+    for (uint32_t i = 0; i < n; i++) {
+        idx = (idx - 1) & ADC_CONT_RING_MASK;
+        sum += c->ring[idx];
+    }
+    portEXIT_CRITICAL(&adc_cont.lock);
+
+    if (n == 0) {
+        return ESP_ERR_NOT_FINISHED;  // No conversion frame received yet
+    }
+
+    *raw_avg = (int)(sum / n);
+    return ESP_OK;
+}
+
+// Caller holds adc1_lock
+static esp_err_t adc_cont_start_locked(const int *gpios, size_t num_gpios)
+{
+    if (adc_cont.handle) {
+        ESP_LOGW(TAG, "Continuous sampling already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (gpios == NULL) {
+        num_gpios = ADC1_GPIO_COUNT;  // Interleave every ADC1 channel in one pattern
+    } else if (num_gpios == 0 || num_gpios > ADC1_GPIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Build the conversion pattern: one entry per channel, converted round-robin
+    adc_digi_pattern_config_t pattern[ADC1_GPIO_COUNT] = {0};
+    memset(adc_cont.slot_of_channel, -1, sizeof(adc_cont.slot_of_channel));
+    for (size_t i = 0; i < num_gpios; i++) {
+        int gpio = gpios ? gpios[i] : adc1_gpio_map[i].gpio;
+        int map_idx = get_adc_map_index(gpio);
+        if (map_idx < 0) {
+            ESP_LOGE(TAG, "GPIO %d is not an ADC1 channel", gpio);
+            return ESP_ERR_INVALID_ARG;
+        }
+        adc_channel_t channel = adc1_gpio_map[map_idx].channel;
+        pattern[i].atten = ADC_ATTEN_DB_12;
+        pattern[i].channel = channel;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+        adc_cont_channel_t *c = &adc_cont.channels[i];
+        c->gpio = gpio;
+        c->channel = channel;
+        c->head = 0;
+        c->count = 0;
+        c->filter = &adc1_filters[map_idx];
+        adc_cont.slot_of_channel[channel] = (int8_t)i;
+    }
+    adc_cont.num_channels = num_gpios;
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = CONFIG_ADC_CONTINUOUS_FRAME_BYTES * 4,
+        .conv_frame_size = CONFIG_ADC_CONTINUOUS_FRAME_BYTES,
+    };
+    esp_err_t ret = adc_continuous_new_handle(&handle_cfg, &adc_cont.handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create continuous ADC handle: %s", esp_err_to_name(ret));
+        adc_cont.handle = NULL;
+        adc_cont.num_channels = 0;
+        return ret;
+    }
+
+    adc_continuous_config_t cont_cfg = {
+        .pattern_num = num_gpios,
+        .adc_pattern = pattern,
+        .sample_freq_hz = CONFIG_ADC_CONTINUOUS_SAMPLE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_CONT_OUTPUT_FORMAT,
+    };
+    ret = adc_continuous_config(adc_cont.handle, &cont_cfg);
+    if (ret == ESP_OK) {
+        adc_continuous_evt_cbs_t cbs = {
+            .on_conv_done = adc_cont_on_conv_done,
+        };
+        ret = adc_continuous_register_event_callbacks(adc_cont.handle, &cbs, NULL);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure continuous ADC: %s", esp_err_to_name(ret));
+        goto fail;
+    }
+
+    adc_cont.stop_requested = false;
+    if (xTaskCreate(adc_cont_task, "adc_dma", ADC_CONT_TASK_STACK, NULL,
+                    ADC_CONT_TASK_PRIORITY, &adc_cont.task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create ADC drain task");
+        adc_cont.task = NULL;
+        ret = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+
+    ret = adc_continuous_start(adc_cont.handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start continuous ADC: %s", esp_err_to_name(ret));
+        adc_cont_task_join();
+        goto fail;
+    }
+
+    // Let the first frame land so an immediate read has data
+    for (int i = 0; i < 10 && adc_cont.channels[0].count == 0; i++) {
+        vTaskDelay(1);
+    }
+
+    ESP_LOGI(TAG, "Continuous ADC sampling started: %u channel(s), %d Hz, %d-sample rings",
+             (unsigned)num_gpios, CONFIG_ADC_CONTINUOUS_SAMPLE_HZ, CONFIG_ADC_CONTINUOUS_RING_SAMPLES);
+    return ESP_OK;
+
+fail:
+    adc_continuous_deinit(adc_cont.handle);
+    adc_cont.handle = NULL;
+    adc_cont.num_channels = 0;
+    return ret;
+}
+
+esp_err_t adc_scanner_continuous_start(const int *gpios, size_t num_gpios)
+{
+    if (!adc1_handle) {
+        ESP_LOGE(TAG, "ADC scanner not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(adc1_lock, portMAX_DELAY);
+    esp_err_t ret = adc_cont_start_locked(gpios, num_gpios);
+    xSemaphoreGive(adc1_lock);
+    return ret;
+}
+
+// Caller holds adc1_lock
+static void adc_cont_stop_locked(void)
+{
+    if (!adc_cont.handle) {
+        return;
+    }
+
+    // Stop conversions first so no callback touches the task being torn down
+    adc_continuous_stop(adc_cont.handle);
+    adc_cont_task_join();
+
+    adc_continuous_deinit(adc_cont.handle);
+    adc_cont.handle = NULL;
+    adc_cont.num_channels = 0;
+
+    ESP_LOGI(TAG, "Continuous ADC sampling stopped");
+}
+
+void adc_scanner_continuous_stop(void)
+{
+    if (adc1_lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(adc1_lock, portMAX_DELAY);
+    adc_cont_stop_locked();
+    xSemaphoreGive(adc1_lock);
+}
+
+bool adc_scanner_continuous_running(void)
+{
+    return adc_cont.handle != NULL;
+}
+
 esp_err_t adc_scanner_init(void)
 {
     if (adc1_handle != NULL) {
@@ -95,6 +455,15 @@ esp_err_t adc_scanner_init(void)
         return ESP_ERR_INVALID_STATE;
     }
 
+    if (adc1_lock == NULL) {
+        adc1_lock = xSemaphoreCreateMutex();
+        adc_cont.task_exited = xSemaphoreCreateBinary();
+        if (adc1_lock == NULL || adc_cont.task_exited == NULL) {
+            ESP_LOGE(TAG, "Failed to create ADC locks");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     // Configure ADC1 unit
     adc_oneshot_unit_init_cfg_t init_config = {
         .unit_id = ADC_UNIT_1,
@@ -121,8 +490,10 @@ esp_err_t adc_scanner_init(void)
         }
     }
 
-    // Initialize calibration
+    // Initialize calibration and fold it into the raw -> mV table
     adc_calibration_init(ADC_UNIT_1, ADC_ATTEN_DB_12, &adc1_cali_handle);
+    adc_build_mv_lut();
+    adc_filters_reset();
 
     ESP_LOGI(TAG, "ADC scanner initialized (ADC1, 12-bit, 0-3.3V range)");
     return ESP_OK;
@@ -130,6 +501,8 @@ esp_err_t adc_scanner_init(void)
 
 void adc_scanner_deinit(void)
 {
+    adc_scanner_continuous_stop();
+
     if (adc1_cali_handle) {
 #if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
         adc_cali_delete_scheme_curve_fitting(adc1_cali_handle);
@@ -163,45 +536,165 @@ esp_err_t adc_scanner_read_gpio(int gpio_num, int *raw_out, int *voltage_mv_out,
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Read multiple samples and average
-    int sum = 0;
-    for (int i = 0; i < num_samples; i++) {
-        int raw;
-        ret = adc_oneshot_read(adc1_handle, channel, &raw);
+    int raw_avg = 0;
+    xSemaphoreTake(adc1_lock, portMAX_DELAY);
+    if (adc_cont.handle) {
+        // DMA engine running: average the most recent window, no ADC access
+        ret = adc_cont_read_average(gpio_num, num_samples, &raw_avg);
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "ADC read failed on GPIO %d: %s", gpio_num, esp_err_to_name(ret));
-            return ret;
+            ESP_LOGD(TAG, "No continuous samples for GPIO %d: %s", gpio_num, esp_err_to_name(ret));
+        }
+    } else {
+        // Read multiple samples and average
+        int sum = 0;
+        for (int i = 0; i < num_samples; i++) {
+            int raw;
+            ret = adc_oneshot_read(adc1_handle, channel, &raw);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "ADC read failed on GPIO %d: %s", gpio_num, esp_err_to_name(ret));
+                break;
+            }
+            sum += raw;
+            vTaskDelay(pdMS_TO_TICKS(2));  // Small delay between samples
         }
-        sum += raw;
-        vTaskDelay(pdMS_TO_TICKS(2));  // Small delay between samples
+        raw_avg = sum / num_samples;
+    }
+    xSemaphoreGive(adc1_lock);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    int raw_avg = sum / num_samples;
     if (raw_out) {
         *raw_out = raw_avg;
     }
 
     // Convert to voltage if calibration is available
     if (voltage_mv_out) {
-        if (adc1_cali_handle) {
-            int voltage;
-            ret = adc_cali_raw_to_voltage(adc1_cali_handle, raw_avg, &voltage);
-            if (ret == ESP_OK) {
-                *voltage_mv_out = voltage;
-            } else {
-                // Fallback: linear approximation (3.3V = 4095 for 12-bit)
-                *voltage_mv_out = (raw_avg * 3300) / 4095;
+        *voltage_mv_out = adc_raw_to_mv(raw_avg);
+    }
+
+    return ESP_OK;
+}
+
+// Check whether a GPIO is part of the running conversion pattern
+static bool adc_cont_has_gpio(int gpio_num)
+{
+    for (size_t i = 0; i < adc_cont.num_channels; i++) {
+        if (adc_cont.channels[i].gpio == gpio_num) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Caller holds adc1_lock
+static esp_err_t adc_read_filtered_group_locked(const int *gpios, size_t num_gpios,
+                                                int *raw_out, int *voltage_mv_out, int num_samples)
+{
+    int map_idx[ADC1_GPIO_COUNT];
+    for (size_t g = 0; g < num_gpios; g++) {
+        map_idx[g] = get_adc_map_index(gpios[g]);
+        if (map_idx[g] < 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (adc_cont.handle && !adc_cont_has_gpio(gpios[g])) {
+            return ESP_ERR_NOT_SUPPORTED;  // ADC1 is owned by the DMA engine
+        }
+    }
+
+    if (!adc_cont.handle) {
+        if (num_samples <= 0) {
+            num_samples = 8;
+        }
+
+        // One conversion sequence for the whole group: every round converts
+        // each channel back to back, so the 2ms pacing is paid once per round
+        // rather than once per channel
+        for (int i = 0; i < num_samples; i++) {
+            for (size_t g = 0; g < num_gpios; g++) {
+                int raw;
+                esp_err_t ret = adc_oneshot_read(adc1_handle, adc1_gpio_map[map_idx[g]].channel, &raw);
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "ADC read failed on GPIO %d: %s", gpios[g], esp_err_to_name(ret));
+                    return ret;
+                }
+                signal_filter_update(&adc1_filters[map_idx[g]], raw);
+            }
+            if (i + 1 < num_samples) {
+                vTaskDelay(pdMS_TO_TICKS(2));
             }
-        } else {
-            // No calibration: linear approximation
-            *voltage_mv_out = (raw_avg * 3300) / 4095;
         }
     }
+    // With the DMA engine running, the drain task has already pushed every
+    // sample through the filters and only the outputs are loaded here
+
+    esp_err_t result = ESP_OK;
+    for (size_t g = 0; g < num_gpios; g++) {
+        signal_filter_t *filter = &adc1_filters[map_idx[g]];
+        if (!filter->ema.primed) {
+            result = ESP_ERR_NOT_FINISHED;  // Window still filling, read again
+            continue;
+        }
 
-    return ESP_OK;
+        int raw = (int)signal_filter_get(filter);
+        if (raw_out) {
+            raw_out[g] = raw;
+        }
+        if (voltage_mv_out) {
+            voltage_mv_out[g] = adc_raw_to_mv(raw);
+        }
+
+        ESP_LOGV(TAG, "GPIO %d filtered raw=%d (%lu outliers rejected)",
+                 gpios[g], raw, (unsigned long)filter->hampel.rejected);
+    }
+
+    return result;
 }
 
-esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size_t max_results)
+esp_err_t adc_scanner_read_filtered_group(const int *gpios, size_t num_gpios,
+                                          int *raw_out, int *voltage_mv_out, int num_samples)
+{
+    if (!adc1_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (gpios == NULL || num_gpios == 0 || num_gpios > ADC1_GPIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(adc1_lock, portMAX_DELAY);
+    esp_err_t ret = adc_read_filtered_group_locked(gpios, num_gpios, raw_out, voltage_mv_out, num_samples);
+    xSemaphoreGive(adc1_lock);
+    return ret;
+}
+
+esp_err_t adc_scanner_read_filtered(int gpio_num, int *raw_out, int *voltage_mv_out, int num_samples)
+{
+    return adc_scanner_read_filtered_group(&gpio_num, 1, raw_out, voltage_mv_out, num_samples);
+}
+
+// Wait until every channel in the pattern holds at least num_samples samples
+static bool adc_cont_wait_filled(uint32_t num_samples, int max_ticks)
+{
+    for (int t = 0; t <= max_ticks; t++) {
+        bool filled = true;
+        portENTER_CRITICAL(&adc_cont.lock);
+        for (size_t i = 0; i < adc_cont.num_channels; i++) {
+            if (adc_cont.channels[i].count < num_samples) {
+                filled = false;
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&adc_cont.lock);
+        if (filled) {
+            return true;
+        }
+        vTaskDelay(1);
+    }
+    return false;
+}
+
+esp_err_t adc_scanner_sweep(adc_scan_result_t *results, size_t *num_results, size_t max_results)
 {
     if (!adc1_handle) {
         ESP_LOGE(TAG, "ADC scanner not initialized");
@@ -212,45 +705,75 @@ esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size
         return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "Scanning ADC1 channels for analog signals...");
-    ESP_LOGI(TAG, "========================================");
+    // Without the background engine, run one interleaved DMA burst over all
+    // channels instead of sampling them one after another. The lock is held
+    // for the whole burst so no one-shot read runs while the engine owns ADC1.
+    xSemaphoreTake(adc1_lock, portMAX_DELAY);
+    bool burst = !adc_cont.handle;
+    if (burst) {
+        esp_err_t ret = adc_cont_start_locked(NULL, 0);
+        if (ret != ESP_OK) {
+            xSemaphoreGive(adc1_lock);
+            return ret;
+        }
+        if (!adc_cont_wait_filled(ADC_SCAN_NUM_SAMPLES, pdMS_TO_TICKS(ADC_SCAN_BURST_TIMEOUT_MS) + 1)) {
+            ESP_LOGW(TAG, "Scan burst incomplete, using the samples received");
+        }
+    }
 
     size_t count = 0;
-    
     for (int i = 0; i < ADC1_GPIO_COUNT && count < max_results; i++) {
         int gpio = adc1_gpio_map[i].gpio;
         int raw = 0;
-        int voltage_mv = 0;
-        
-        esp_err_t ret = adc_scanner_read_gpio(gpio, &raw, &voltage_mv, 64);
+
+        // De-interleaved samples of this channel are already in its ring
+        esp_err_t ret = adc_cont_read_average(gpio, ADC_SCAN_NUM_SAMPLES, &raw);
         if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to read GPIO %d", gpio);
+            ESP_LOGD(TAG, "No samples for GPIO %d: %s", gpio, esp_err_to_name(ret));
             continue;
         }
 
-        // Store result
         results[count].gpio_num = gpio;
         results[count].adc_channel = adc1_gpio_map[i].channel;
         results[count].raw_value = raw;
-        results[count].voltage_mv = voltage_mv;
-        
+        results[count].voltage_mv = adc_raw_to_mv(raw);
+
         // Heuristic: A connected analog sensor typically reads between 10% and 90% of range
         // (not stuck at 0V or 3.3V rail). For 12-bit ADC: ~400 to 3700
-        bool looks_analog = (raw > 400 && raw < 3700);
-        results[count].looks_connected = looks_analog;
-        
-        ESP_LOGI(TAG, "GPIO %2d (CH%d): Raw=%4d, Voltage=%4d mV %s", 
-                 gpio, 
-                 adc1_gpio_map[i].channel,
-                 raw, 
-                 voltage_mv,
-                 looks_analog ? "✓ [ANALOG SIGNAL DETECTED]" : "");
-        
+        results[count].looks_connected = (raw > 400 && raw < 3700);
         count++;
     }
 
+    if (burst) {
+        adc_cont_stop_locked();
+    }
+    xSemaphoreGive(adc1_lock);
+
     *num_results = count;
+    return count > 0 ? ESP_OK : ESP_ERR_NOT_FINISHED;
+}
+
+esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size_t max_results)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "Scanning ADC1 channels for analog signals...");
+    ESP_LOGI(TAG, "========================================");
+
+    esp_err_t ret = adc_scanner_sweep(results, num_results, max_results);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ADC scan failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    size_t count = *num_results;
+    for (int i = 0; i < count; i++) {
+        ESP_LOGI(TAG, "GPIO %2d (CH%d): Raw=%4d, Voltage=%4d mV %s", 
+                 results[i].gpio_num, 
+                 results[i].adc_channel,
+                 results[i].raw_value, 
+                 results[i].voltage_mv,
+                 results[i].looks_connected ? "✓ [ANALOG SIGNAL DETECTED]" : "");
+    }
 
     ESP_LOGI(TAG, "========================================");
     ESP_LOGI(TAG, "Scan complete. %d channels tested.", count);
@@ -280,3 +803,38 @@ esp_err_t adc_scanner_scan(adc_scan_result_t *results, size_t *num_results, size
 
     return ESP_OK;
 }
+
+esp_err_t adc_scanner_check_presence(void)
+{
+    static uint32_t present_mask = 0;
+    static bool first_check = true;
+
+    adc_scan_result_t results[ADC1_GPIO_COUNT];
+    size_t count = 0;
+    esp_err_t ret = adc_scanner_sweep(results, &count, ADC1_GPIO_COUNT);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Only log channels whose presence changed since the previous sweep
+    uint32_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bit = 1u << (results[i].gpio_num % 32);
+        if (results[i].looks_connected) {
+            mask |= bit;
+        }
+        if (first_check || ((mask ^ present_mask) & bit)) {
+            if (results[i].looks_connected) {
+                ESP_LOGI(TAG, "Analog sensor present on GPIO %d (%d mV)", 
+                         results[i].gpio_num, results[i].voltage_mv);
+            } else if (!first_check) {
+                ESP_LOGW(TAG, "Analog sensor lost on GPIO %d (%d mV)", 
+                         results[i].gpio_num, results[i].voltage_mv);
+            }
+        }
+    }
+
+    present_mask = mask;
+    first_check = false;
+    return ESP_OK;
+}
@@ -0,0 +1,123 @@
+#include "cbor_writer.h"
+#include <string.h>
+
+// Major types (high 3 bits of the initial byte)
+#define CBOR_MAJOR_UINT    0x00
+#define CBOR_MAJOR_NEGINT  0x20
+#define CBOR_MAJOR_BYTES   0x40
+#define CBOR_MAJOR_TEXT    0x60
+#define CBOR_MAJOR_ARRAY   0x80
+#define CBOR_MAJOR_MAP     0xA0
+
+// Simple values
+#define CBOR_FALSE         0xF4
+#define CBOR_TRUE          0xF5
+#define CBOR_NULL          0xF6
+
+static inline void put_bytes(cbor_writer_t *w, const void *data, size_t n)
+{
+    if (w->overflow || w->len + n > w->cap) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(&w->buf[w->len], data, n);
+    w->len += n;
+}
+
+// Initial byte plus big-endian argument in the shortest form
+static void put_head(cbor_writer_t *w, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t n;
+
+    if (value < 24) {
+        head[0] = major | (uint8_t)value;
+        n = 1;
+    } else if (value <= 0xFF) {
+        head[0] = major | 24;
+        head[1] = (uint8_t)value;
+        n = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = major | 25;
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        n = 3;
+    } else if (value <= 0xFFFFFFFFu) {
+        head[0] = major | 26;
+        for (int i = 0; i < 4; i++) {
+            head[1 + i] = (uint8_t)(value >> (24 - 8 * i));
+        }
+        n = 5;
+    } else {
+        head[0] = major | 27;
+        for (int i = 0; i < 8; i++) {
+            head[1 + i] = (uint8_t)(value >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+
+    put_bytes(w, head, n);
+}
+
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0;
+    w->overflow = (buf == NULL);
+}
+
+void cbor_writer_uint(cbor_writer_t *w, uint64_t value)
+{
+    put_head(w, CBOR_MAJOR_UINT, value);
+}
+
+void cbor_writer_int(cbor_writer_t *w, int64_t value)
+{
+    if (value >= 0) {
+        put_head(w, CBOR_MAJOR_UINT, (uint64_t)value);
+    } else {
+        // Negative n is encoded as -1 - n
+        put_head(w, CBOR_MAJOR_NEGINT, (uint64_t)(-1 - value));
+    }
+}
+
+void cbor_writer_text(cbor_writer_t *w, const char *value)
+{
+    size_t len = strlen(value);
+    put_head(w, CBOR_MAJOR_TEXT, len);
+    put_bytes(w, value, len);
+}
+
+void cbor_writer_bytes(cbor_writer_t *w, const void *data, size_t len)
+{
+    put_head(w, CBOR_MAJOR_BYTES, len);
+    put_bytes(w, data, len);
+}
+
+void cbor_writer_bool(cbor_writer_t *w, bool value)
+{
+    uint8_t b = value ? CBOR_TRUE : CBOR_FALSE;
+    put_bytes(w, &b, 1);
+}
+
+void cbor_writer_null(cbor_writer_t *w)
+{
+    uint8_t b = CBOR_NULL;
+    put_bytes(w, &b, 1);
+}
+
+void cbor_writer_array(cbor_writer_t *w, size_t count)
+{
+    put_head(w, CBOR_MAJOR_ARRAY, count);
+}
+
+void cbor_writer_map(cbor_writer_t *w, size_t count)
+{
+    put_head(w, CBOR_MAJOR_MAP, count);
+}
+
+size_t cbor_writer_finish(const cbor_writer_t *w)
+{
+    return w->overflow ? 0 : w->len;
+}
@@ -0,0 +1,122 @@
+#include "dht11_decoder.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Protocol timing (microseconds, nominal sensor clock). Bits are measured
+// falling edge to falling edge: ~50us LOW + ~27us ('0') or ~70us ('1') HIGH.
+#define DHT11_GLITCH_US           8      // Edges this close together belong to a noise spike
+#define DHT11_MIN_BIT_PERIOD_US   40     // Shortest plausible period under skew and ISR latency
+#define DHT11_RESPONSE_MIN_US     100    // Response LOW + HIGH is ~160us
+#define DHT11_RESPONSE_MAX_US     220
+#define DHT11_BIT_MIN_SPREAD_US   20     // Min gap between '0' and '1' periods to trust min/max
+#define DHT11_NUM_BITS            40
+
+/**
+ * @brief Drop non-transitions and spikes so the edges strictly alternate
+ * 
+ * @return size_t Number of edges left
+ */
+static size_t dht11_clean_edges(dht11_edge_t *edges, size_t count)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (n > 0 && edges[i].level == edges[n - 1].level) {
+            continue;  // Level did not change (ISR saw the line after a spike settled)
+        }
+        if (n > 0 && (uint32_t)(edges[i].time_us - edges[n - 1].time_us) < DHT11_GLITCH_US) {
+            n--;       // Too short to be real: remove the pulse, the previous level continues
+            continue;
+        }
+        edges[n++] = edges[i];
+    }
+
+    return n;
+}
+
+/**
+ * @brief Keep only the falling edges that can start a bit, compacted in place
+ * 
+ * Bits are timed between falling edges only: the line then stays LOW for
+ * ~50us, so those edges are the ones least distorted by ISR latency. A falling
+ * edge closer than one minimum bit period to the previous one is noise.
+ * 
+ * @return size_t Number of falling edges kept
+ */
+static size_t dht11_collect_falls(dht11_edge_t *edges, size_t count)
+{
+    size_t n = 0;
+
+    count = dht11_clean_edges(edges, count);
+    for (size_t i = 0; i < count; i++) {
+        if (edges[i].level != 0) {
+            continue;
+        }
+        if (n > 0 && (uint32_t)(edges[i].time_us - edges[n - 1].time_us) < DHT11_MIN_BIT_PERIOD_US) {
+            continue;
+        }
+        edges[n++] = edges[i];
+    }
+
+    return n;
+}
+
+dht11_decode_status_t dht11_decode_frame(dht11_edge_t *edges, size_t count, uint8_t data[5])
+{
+    uint32_t period_us[DHT11_NUM_BITS];
+    memset(data, 0, 5);
+
+    size_t falls = dht11_collect_falls(edges, count);
+
+    // Find the response: falling edge, ~80us LOW, ~80us HIGH, falling edge of bit 0
+    size_t i = 0;
+    bool found = false;
+    for (; i + 1 < falls; i++) {
+        uint32_t response = edges[i + 1].time_us - edges[i].time_us;
+        if (response >= DHT11_RESPONSE_MIN_US && response <= DHT11_RESPONSE_MAX_US) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        return DHT11_DECODE_NO_RESPONSE;
+    }
+
+    // 40 bits need 41 falling edges after the response (the last one ends bit 39)
+    size_t first = i + 1;
+    if (first + DHT11_NUM_BITS >= falls) {
+        return DHT11_DECODE_BIT_TIMEOUT;
+    }
+
+    uint32_t period_min = UINT32_MAX;
+    uint32_t period_max = 0;
+    for (int bit = 0; bit < DHT11_NUM_BITS; bit++) {
+        period_us[bit] = edges[first + bit + 1].time_us - edges[first + bit].time_us;
+        if (period_us[bit] < period_min) period_min = period_us[bit];
+        if (period_us[bit] > period_max) period_max = period_us[bit];
+    }
+
+    // Split the two period populations in the middle. A frame with only one
+    // population (all 0s or all 1s) scales the nominal 98us split by the
+    // measured response length, which tracks the sensor clock.
+    uint32_t threshold;
+    if (period_max - period_min >= DHT11_BIT_MIN_SPREAD_US) {
+        threshold = (period_min + period_max) / 2;
+    } else {
+        uint32_t response = edges[first].time_us - edges[i].time_us;
+        threshold = response * 98 / 160;
+    }
+
+    for (int bit = 0; bit < DHT11_NUM_BITS; bit++) {
+        if (period_us[bit] > threshold) {
+            data[bit / 8] |= (1 << (7 - (bit % 8)));  // MSB first
+        }
+    }
+
+    uint8_t checksum = data[0] + data[1] + data[2] + data[3];
+    if (checksum != data[4]) {
+        return DHT11_DECODE_BAD_CHECKSUM;
+    }
+
+    return DHT11_DECODE_OK;
+}
@@ -1,130 +1,191 @@
 #include "dht11_manager.h"
+#include "dht11_decoder.h"
+#include "config.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "rom/ets_sys.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "DHT11_MANAGER";
 
 // DHT11 timing constants (microseconds)
 #define DHT11_START_SIGNAL_LOW_TIME   20000  // 18-20ms (increased for reliability)
-#define DHT11_START_SIGNAL_HIGH_TIME  30     // 20-40us
-#define DHT11_RESPONSE_TIMEOUT        200    // Max wait for response (increased)
-#define DHT11_BIT_TIMEOUT             150    // Max wait for bit signal (increased)
+#define DHT11_STABILIZATION_TIME_US   1000000  // DHT11 needs ~1s after power-on
+
+// Edge capture constants
+#define DHT11_FRAME_EDGES             85     // Release + response (2) + 40 bits (2 each) + trailing LOW/HIGH
+#define DHT11_MAX_EDGES               96     // Some headroom for glitches
+#define DHT11_CAPTURE_TIMEOUT_US      10000  // Full frame takes ~4.5ms
+#define DHT11_CYCLE_SLACK_US          5000   // Late phase timer tolerated before a read counts as stuck
+
+// Acquisition state machine (shared by all sensors, which are read in parallel)
+typedef enum {
+    DHT11_PHASE_IDLE,          // No read in progress
+    DHT11_PHASE_START_SIGNAL,  // Lines held LOW, waiting for the phase timer
+    DHT11_PHASE_CAPTURING,     // Lines released, ISRs timestamping edges
+    DHT11_PHASE_CAPTURED       // Capture window closed, frames ready to decode
+} dht11_phase_t;
+
+// Per-sensor capture channel: each data line has its own ISR argument and edge buffer
+typedef struct {
+    int gpio_num;
+    dht11_data_t last_reading;      // Last valid reading (cache)
+    dht11_data_t result;            // Outcome of the last completed read
+    esp_err_t result_err;
+    bool result_pending;            // Result not yet collected with poll
+    bool active;                    // Taking part in the current read
+    dht11_stats_t stats;            // Failure counters and breaker state
+    int64_t retry_time_us;          // Breaker open: no read attempt before this time
+    volatile uint32_t edge_count;
+    dht11_edge_t edges[DHT11_MAX_EDGES];
+} dht11_sensor_t;
 
 // Module state
 static struct {
-    int gpio_num;
+    dht11_sensor_t sensors[CONFIG_DHT11_MAX_SENSORS];
+    size_t num_sensors;
+    size_t num_active;              // Sensors taking part in the current read
     bool initialized;
-    dht11_data_t last_reading;
+    int64_t ready_time_us;
+    esp_timer_handle_t phase_timer;
+    SemaphoreHandle_t capture_done;
+    portMUX_TYPE lock;
+    volatile dht11_phase_t phase;
+    volatile uint32_t frames_done;  // Sensors whose frame is fully captured
+    int64_t deadline_us;            // Read still running after this time is closed by the poller
 } dht11_state = {
-    .gpio_num = -1,
+    .num_sensors = 0,
+    .num_active = 0,
     .initialized = false,
-    .last_reading = {0}
+    .ready_time_us = 0,
+    .phase_timer = NULL,
+    .capture_done = NULL,
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+    .phase = DHT11_PHASE_IDLE,
+    .frames_done = 0,
+    .deadline_us = 0
 };
 
 /**
- * @brief Read 40 bits of data from DHT11 (must be called from critical section)
+ * @brief GPIO edge ISR: timestamp every transition on one sensor's data line
  * 
- * @param data Buffer to store 5 bytes (humidity_int, humidity_dec, temp_int, temp_dec, checksum)
- * @return esp_err_t ESP_OK if successful
+ * Decoding is deferred to task context, so the ISR only records the edge
+ * time and the line level after the edge.
  * 
- * NOTE: This function MUST be called with interrupts disabled.
- * NO logging allowed inside this function!
+ * @param arg The dht11_sensor_t owning the line
  */
-static esp_err_t dht11_read_raw(uint8_t data[5])
+static void IRAM_ATTR dht11_edge_isr(void *arg)
 {
-    memset(data, 0, 5);
-    int timeout;
-    
-    // Send start signal: LOW for 18-20ms, then HIGH for 20-40us
-    gpio_set_direction(dht11_state.gpio_num, GPIO_MODE_OUTPUT);
-    gpio_set_level(dht11_state.gpio_num, 0);
-    ets_delay_us(DHT11_START_SIGNAL_LOW_TIME);
-    
-    gpio_set_level(dht11_state.gpio_num, 1);
-    ets_delay_us(DHT11_START_SIGNAL_HIGH_TIME);
-    
-    // Switch to input mode to read sensor response
-    gpio_set_direction(dht11_state.gpio_num, GPIO_MODE_INPUT);
-    
-    // Small delay to let the line stabilize
-    ets_delay_us(2);
-    
-    // Wait for sensor to pull line LOW (response signal ~80us)
-    timeout = 0;
-    while (gpio_get_level(dht11_state.gpio_num) == 1) {
-        if (++timeout > DHT11_RESPONSE_TIMEOUT) {
-            return ESP_ERR_TIMEOUT;  // Error code 1: no response LOW
-        }
-        ets_delay_us(1);
+    dht11_sensor_t *sensor = (dht11_sensor_t *)arg;
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    int level = gpio_get_level(sensor->gpio_num);
+    uint32_t frames_done = 0;
+    BaseType_t higher_prio_woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&dht11_state.lock);
+    if (dht11_state.phase != DHT11_PHASE_CAPTURING) {
+        // Late edge after the window closed: the frame is already being decoded
+        portEXIT_CRITICAL_ISR(&dht11_state.lock);
+        return;
     }
-    
-    // Wait for sensor to pull line HIGH (~80us)
-    timeout = 0;
-    while (gpio_get_level(dht11_state.gpio_num) == 0) {
-        if (++timeout > DHT11_RESPONSE_TIMEOUT) {
-            return ESP_ERR_TIMEOUT;  // Error code 2: no response HIGH
+    uint32_t idx = sensor->edge_count;
+    if (idx < DHT11_MAX_EDGES) {
+        sensor->edges[idx].time_us = now_us;
+        sensor->edges[idx].level = (uint8_t)level;
+        sensor->edge_count = idx + 1;
+    }
+    if (idx + 1 == DHT11_FRAME_EDGES) {
+        frames_done = ++dht11_state.frames_done;
+    }
+    portEXIT_CRITICAL_ISR(&dht11_state.lock);
+
+    // Wake a blocked reader as soon as every sensor has delivered a complete frame
+    if (frames_done == dht11_state.num_active) {
+        xSemaphoreGiveFromISR(dht11_state.capture_done, &higher_prio_woken);
+        if (higher_prio_woken) {
+            portYIELD_FROM_ISR();
         }
-        ets_delay_us(1);
     }
-    
-    // Wait for sensor to pull line LOW (start of data transmission ~50us)
-    timeout = 0;
-    while (gpio_get_level(dht11_state.gpio_num) == 1) {
-        if (++timeout > DHT11_RESPONSE_TIMEOUT) {
-            return ESP_ERR_TIMEOUT;  // Error code 3: no data start
+}
+
+/**
+ * @brief Move the read cycle from one phase to another if it is still in the first
+ * 
+ * Every phase change goes through the lock, so the phase timer and the task
+ * polling the read can never overwrite each other's transition.
+ * 
+ * @return true if the phase was changed
+ */
+static bool dht11_phase_cas(dht11_phase_t from, dht11_phase_t to)
+{
+    bool changed = false;
+
+    portENTER_CRITICAL(&dht11_state.lock);
+    if (dht11_state.phase == from) {
+        dht11_state.phase = to;
+        changed = true;
+    }
+    portEXIT_CRITICAL(&dht11_state.lock);
+
+    return changed;
+}
+
+/**
+ * @brief Phase timer callback (esp_timer task context)
+ * 
+ * Ends the start signal by releasing all lines together and arming the edge
+ * capture, then closes the capture window when the timer fires a second time.
+ * The timer only ever moves START_SIGNAL to CAPTURING and CAPTURING to
+ * CAPTURED; a window the poller already closed is left alone.
+ */
+static void dht11_phase_timer_cb(void *arg)
+{
+    bool armed = false;
+
+    // Arm the edge capture before releasing the lines
+    portENTER_CRITICAL(&dht11_state.lock);
+    if (dht11_state.phase == DHT11_PHASE_START_SIGNAL) {
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            dht11_state.sensors[i].edge_count = 0;
         }
-        ets_delay_us(1);
+        dht11_state.frames_done = 0;
+        dht11_state.phase = DHT11_PHASE_CAPTURING;
+        armed = true;
     }
-    
-    // Read 40 bits of data
-    for (int i = 0; i < 40; i++) {
-        // Wait for LOW to HIGH transition (start of bit ~50us LOW)
-        timeout = 0;
-        while (gpio_get_level(dht11_state.gpio_num) == 0) {
-            if (++timeout > DHT11_BIT_TIMEOUT) {
-                return ESP_ERR_TIMEOUT;  // Timeout on bit start
+    portEXIT_CRITICAL(&dht11_state.lock);
+
+    if (armed) {
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            if (dht11_state.sensors[i].active) {
+                gpio_intr_enable(dht11_state.sensors[i].gpio_num);
             }
-            ets_delay_us(1);
         }
-        
-        // Measure HIGH pulse duration to determine bit value
-        // 26-28us = 0, 70us = 1
-        ets_delay_us(40);  // Sample in the middle
-        int bit_value = gpio_get_level(dht11_state.gpio_num);
-        
-        // Store bit
-        int byte_idx = i / 8;
-        int bit_idx = 7 - (i % 8);  // MSB first
-        if (bit_value) {
-            data[byte_idx] |= (1 << bit_idx);
-        }
-        
-        // Wait for bit to end (line goes LOW)
-        timeout = 0;
-        while (gpio_get_level(dht11_state.gpio_num) == 1) {
-            if (++timeout > DHT11_BIT_TIMEOUT) {
-                return ESP_ERR_TIMEOUT;  // Timeout waiting for bit end
+
+        // Release the lines (pull-ups take them HIGH) and let the sensors answer
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            if (dht11_state.sensors[i].active) {
+                gpio_set_level(dht11_state.sensors[i].gpio_num, 1);
             }
-            ets_delay_us(1);
         }
+        esp_timer_start_once(dht11_state.phase_timer, DHT11_CAPTURE_TIMEOUT_US);
+    } else if (dht11_phase_cas(DHT11_PHASE_CAPTURING, DHT11_PHASE_CAPTURED)) {
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            gpio_intr_disable(dht11_state.sensors[i].gpio_num);
+        }
+        xSemaphoreGive(dht11_state.capture_done);
     }
-    
-    return ESP_OK;
 }
 
 /**
- * @brief Validate checksum and parse sensor data
+ * @brief Convert a decoded frame to sensor data
  * 
- * @param raw_data Raw 5-byte data from sensor
+ * @param raw_data Raw 5-byte data from sensor (checksum already validated)
  * @param parsed Output parsed data structure
- * @return esp_err_t ESP_OK if checksum valid
  */
-static esp_err_t dht11_parse_data(const uint8_t raw_data[5], dht11_data_t *parsed)
+static void dht11_parse_data(const uint8_t raw_data[5], dht11_data_t *parsed)
 {
     // DHT11 data format:
     // [0] = Humidity integer part
@@ -133,67 +194,369 @@ static esp_err_t dht11_parse_data(const uint8_t raw_data[5], dht11_data_t *parse
     // [3] = Temperature decimal part (always 0 for DHT11)
     // [4] = Checksum (sum of bytes 0-3)
     
-    uint8_t checksum = raw_data[0] + raw_data[1] + raw_data[2] + raw_data[3];
-    if (checksum != raw_data[4]) {
-        ESP_LOGE(TAG, "Checksum error: calculated=0x%02X, received=0x%02X", 
-                 checksum, raw_data[4]);
-        return ESP_ERR_INVALID_CRC;
-    }
-    
     // DHT11 only provides integer values, decimal parts are always 0
     parsed->humidity = (float)raw_data[0];
     parsed->temperature = (float)raw_data[2];
     parsed->valid = true;
-    
-    ESP_LOGD(TAG, "Sensor data: Temp=%.1f°C, Humidity=%.1f%%", 
-             parsed->temperature, parsed->humidity);
-    
+}
+
+/**
+ * @brief Check whether the circuit breaker lets a sensor be read
+ */
+static bool dht11_breaker_allows(const dht11_sensor_t *sensor, int64_t now_us)
+{
+    // An open breaker lets one retry through once the backoff has elapsed
+    return !sensor->stats.breaker_open || now_us >= sensor->retry_time_us;
+}
+
+/**
+ * @brief Human-readable failure reason for logs
+ */
+static const char *dht11_failure_name(dht11_decode_status_t status)
+{
+    switch (status) {
+    case DHT11_DECODE_NO_RESPONSE:
+        return "no response";
+    case DHT11_DECODE_BIT_TIMEOUT:
+        return "truncated frame";
+    case DHT11_DECODE_BAD_CHECKSUM:
+        return "checksum error";
+    default:
+        return "ok";
+    }
+}
+
+/**
+ * @brief Update the circuit breaker after a read attempt
+ * 
+ * After CONFIG_DHT11_BREAKER_THRESHOLD consecutive failures the sensor is left
+ * out of reads for CONFIG_DHT11_BREAKER_BASE_MS. Every failed retry doubles the
+ * backoff up to CONFIG_DHT11_BREAKER_MAX_MS; one good read closes the breaker.
+ * Only state changes are logged, so a dead sensor does not flood the log.
+ * 
+ * @param sensor Sensor that was read
+ * @param status Decode result
+ * @param edge_count Number of edges captured (for diagnostics)
+ */
+static void dht11_breaker_update(dht11_sensor_t *sensor, dht11_decode_status_t status, uint32_t edge_count)
+{
+    dht11_stats_t *stats = &sensor->stats;
+
+    if (status == DHT11_DECODE_OK) {
+        if (stats->breaker_open) {
+            ESP_LOGI(TAG, "Sensor on GPIO %d recovered after %lu failed reads",
+                     sensor->gpio_num, (unsigned long)stats->consecutive_failures);
+        }
+        stats->consecutive_failures = 0;
+        stats->breaker_open = false;
+        stats->backoff_ms = 0;
+        return;
+    }
+
+    stats->consecutive_failures++;
+    if (stats->consecutive_failures == 1) {
+        ESP_LOGW(TAG, "Read failed on GPIO %d: %s (%lu edges captured)",
+                 sensor->gpio_num, dht11_failure_name(status), (unsigned long)edge_count);
+    } else {
+        ESP_LOGD(TAG, "Read failed on GPIO %d: %s (%lu edges captured)",
+                 sensor->gpio_num, dht11_failure_name(status), (unsigned long)edge_count);
+    }
+
+    if (stats->consecutive_failures < CONFIG_DHT11_BREAKER_THRESHOLD) {
+        return;
+    }
+
+    uint32_t backoff_ms = CONFIG_DHT11_BREAKER_BASE_MS;
+    if (stats->breaker_open) {
+        backoff_ms = stats->backoff_ms * 2;
+        if (backoff_ms > CONFIG_DHT11_BREAKER_MAX_MS) {
+            backoff_ms = CONFIG_DHT11_BREAKER_MAX_MS;
+        }
+    } else {
+        stats->breaker_trips++;
+        ESP_LOGE(TAG, "Sensor on GPIO %d failed %lu reads in a row, pausing reads",
+                 sensor->gpio_num, (unsigned long)stats->consecutive_failures);
+        ESP_LOGE(TAG, "Troubleshooting: Check GPIO %d wiring, pull-up resistor (4.7k-10k), and sensor power",
+                 sensor->gpio_num);
+    }
+
+    stats->breaker_open = true;
+    stats->backoff_ms = backoff_ms;
+    sensor->retry_time_us = esp_timer_get_time() + (int64_t)backoff_ms * 1000;
+    ESP_LOGD(TAG, "GPIO %d: next retry in %lu ms", sensor->gpio_num, (unsigned long)backoff_ms);
+}
+
+/**
+ * @brief Decode one sensor's captured frame into its pending result
+ * 
+ * @param sensor Sensor whose capture window has closed
+ */
+static void dht11_decode_sensor(dht11_sensor_t *sensor)
+{
+    portENTER_CRITICAL(&dht11_state.lock);
+    uint32_t count = sensor->edge_count;
+    portEXIT_CRITICAL(&dht11_state.lock);
+
+    uint8_t raw_data[5];
+    dht11_decode_status_t status = dht11_decode_frame(sensor->edges, count, raw_data);
+
+    sensor->result_pending = true;
+    sensor->result.valid = false;
+
+    switch (status) {
+    case DHT11_DECODE_OK:
+        dht11_parse_data(raw_data, &sensor->result);
+        sensor->result_err = ESP_OK;
+        sensor->stats.reads_ok++;
+
+        // Cache last valid reading
+        memcpy(&sensor->last_reading, &sensor->result, sizeof(dht11_data_t));
+
+        ESP_LOGD(TAG, "GPIO %d: Temperature: %.1f°C, Humidity: %.1f%%",
+                 sensor->gpio_num, sensor->result.temperature, sensor->result.humidity);
+        break;
+
+    case DHT11_DECODE_NO_RESPONSE:
+        sensor->stats.no_response++;
+        sensor->result_err = ESP_ERR_TIMEOUT;
+        break;
+
+    case DHT11_DECODE_BIT_TIMEOUT:
+        sensor->stats.bit_timeout++;
+        sensor->result_err = ESP_ERR_TIMEOUT;
+        break;
+
+    case DHT11_DECODE_BAD_CHECKSUM:
+        ESP_LOGD(TAG, "Checksum error on GPIO %d: calculated=0x%02X, received=0x%02X", sensor->gpio_num,
+                 (uint8_t)(raw_data[0] + raw_data[1] + raw_data[2] + raw_data[3]), raw_data[4]);
+        sensor->stats.crc_error++;
+        sensor->result_err = ESP_ERR_INVALID_CRC;
+        break;
+    }
+
+    dht11_breaker_update(sensor, status, count);
+}
+
+/**
+ * @brief Advance the shared read cycle and decode every frame once it completes
+ * 
+ * The poller closes the capture window itself once every frame is complete,
+ * or once the read has overrun its deadline (a lost or late phase timer).
+ * Either way every active sensor is decoded, so a sensor whose frame is
+ * incomplete gets a failure result and the cycle always returns to IDLE.
+ * 
+ * @return esp_err_t ESP_OK if no read is in progress (new results, if any, are pending),
+ *         ESP_ERR_NOT_FINISHED while the read is still in progress
+ */
+static esp_err_t dht11_complete_cycle(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    bool overdue = false;
+    bool claimed = false;
+
+    portENTER_CRITICAL(&dht11_state.lock);
+    dht11_phase_t phase = dht11_state.phase;
+    if (phase == DHT11_PHASE_START_SIGNAL || phase == DHT11_PHASE_CAPTURING) {
+        overdue = now_us >= dht11_state.deadline_us;
+        // Complete frames can be decoded before the capture window expires
+        if (overdue || (phase == DHT11_PHASE_CAPTURING && dht11_state.frames_done >= dht11_state.num_active)) {
+            dht11_state.phase = DHT11_PHASE_CAPTURED;
+            claimed = true;
+        }
+    }
+    portEXIT_CRITICAL(&dht11_state.lock);
+
+    if (phase == DHT11_PHASE_IDLE) {
+        return ESP_OK;
+    }
+    if (phase != DHT11_PHASE_CAPTURED && !claimed) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    if (claimed) {
+        esp_timer_stop(dht11_state.phase_timer);
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            gpio_intr_disable(dht11_state.sensors[i].gpio_num);
+        }
+        if (overdue) {
+            ESP_LOGW(TAG, "Read stuck in phase %d, closing it", (int)phase);
+            for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+                gpio_set_level(dht11_state.sensors[i].gpio_num, 1);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+        if (dht11_state.sensors[i].active) {
+            dht11_decode_sensor(&dht11_state.sensors[i]);
+        }
+    }
+    dht11_phase_cas(DHT11_PHASE_CAPTURED, DHT11_PHASE_IDLE);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Run one blocking read cycle on all sensors
+ * 
+ * @return esp_err_t ESP_OK when every sensor has a pending result
+ */
+static esp_err_t dht11_run_cycle(void)
+{
+    // A read already started by the non-blocking API is simply waited for
+    if (dht11_state.phase == DHT11_PHASE_IDLE) {
+        // Blocking callers still wait out the power-on stabilization
+        int64_t wait_us = dht11_state.ready_time_us - esp_timer_get_time();
+        if (wait_us > 0) {
+            vTaskDelay(pdMS_TO_TICKS(wait_us / 1000) + 1);
+        }
+
+        esp_err_t err = dht11_manager_start_read();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    // Sleep until the ISRs report full frames or the capture window closes
+    TickType_t max_wait = pdMS_TO_TICKS((DHT11_START_SIGNAL_LOW_TIME + DHT11_CAPTURE_TIMEOUT_US) / 1000) + 2;
+    xSemaphoreTake(dht11_state.capture_done, max_wait);
+
+    // Bounded by the read deadline: past it the poller closes the window itself
+    while (dht11_complete_cycle() == ESP_ERR_NOT_FINISHED) {
+        vTaskDelay(1);
+    }
+
     return ESP_OK;
 }
 
-esp_err_t dht11_manager_init(int gpio_num)
+/**
+ * @brief Hand out a sensor's pending result (each result is returned once)
+ */
+static esp_err_t dht11_take_result(dht11_sensor_t *sensor, dht11_data_t *data)
+{
+    if (!sensor->result_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    sensor->result_pending = false;
+    memcpy(data, &sensor->result, sizeof(dht11_data_t));
+    return sensor->result_err;
+}
+
+esp_err_t dht11_manager_init(const int *gpio_nums, size_t num_sensors)
 {
-    if (gpio_num < 0 || gpio_num > 39) {
-        ESP_LOGE(TAG, "Invalid GPIO number: %d", gpio_num);
+    if (gpio_nums == NULL || num_sensors == 0 || num_sensors > CONFIG_DHT11_MAX_SENSORS) {
+        ESP_LOGE(TAG, "Invalid sensor list (%u sensors, max %d)",
+                 (unsigned)num_sensors, CONFIG_DHT11_MAX_SENSORS);
         return ESP_ERR_INVALID_ARG;
     }
 
+    uint64_t pin_mask = 0;
+    for (size_t i = 0; i < num_sensors; i++) {
+        if (gpio_nums[i] < 0 || gpio_nums[i] > 39) {
+            ESP_LOGE(TAG, "Invalid GPIO number: %d", gpio_nums[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (pin_mask & (1ULL << gpio_nums[i])) {
+            ESP_LOGE(TAG, "GPIO %d listed twice", gpio_nums[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+        pin_mask |= 1ULL << gpio_nums[i];
+    }
+
     if (dht11_state.initialized) {
         ESP_LOGW(TAG, "DHT11 manager already initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Configure GPIO with pull-up (DHT11 requires pull-up resistor)
+    // Configure GPIOs with pull-up (DHT11 requires pull-up resistor)
     gpio_config_t io_conf = {
-        .pin_bit_mask = 1ULL << gpio_num,
-        .mode = GPIO_MODE_OUTPUT_OD,  // Open-drain for bidirectional communication
+        .pin_bit_mask = pin_mask,
+        .mode = GPIO_MODE_INPUT_OUTPUT_OD,  // Open-drain, input stays readable while released
         .pull_up_en = GPIO_PULLUP_ENABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
+        .intr_type = GPIO_INTR_ANYEDGE       // Edge capture, enabled only during a read
     };
 
     esp_err_t err = gpio_config(&io_conf);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure GPIO %d: %s", gpio_num, esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to configure DHT11 GPIOs: %s", esp_err_to_name(err));
         return err;
     }
 
-    // Set initial state to HIGH
-    gpio_set_level(gpio_num, 1);
+    for (size_t i = 0; i < num_sensors; i++) {
+        gpio_intr_disable(gpio_nums[i]);
 
-    dht11_state.gpio_num = gpio_num;
-    dht11_state.initialized = true;
-    dht11_state.last_reading.valid = false;
+        // Set initial state to HIGH
+        gpio_set_level(gpio_nums[i], 1);
+    }
+
+    if (dht11_state.capture_done == NULL) {
+        dht11_state.capture_done = xSemaphoreCreateBinary();
+        if (dht11_state.capture_done == NULL) {
+            ESP_LOGE(TAG, "Failed to create capture semaphore");
+            err = ESP_ERR_NO_MEM;
+            goto fail;
+        }
+    }
 
-    ESP_LOGI(TAG, "DHT11 manager initialized on GPIO %d", gpio_num);
-    ESP_LOGI(TAG, "Waiting 1s for sensor stabilization...");
+    if (dht11_state.phase_timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = dht11_phase_timer_cb,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "dht11_phase",
+        };
+        err = esp_timer_create(&timer_args, &dht11_state.phase_timer);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create phase timer: %s", esp_err_to_name(err));
+            goto fail;
+        }
+    }
 
-    // Wait for sensor stabilization (DHT11 needs ~1s after power-on)
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    // The ISR service may already be installed by another module
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s", esp_err_to_name(err));
+        goto fail;
+    }
 
-    ESP_LOGI(TAG, "DHT11 ready. Ensure sensor has 4.7k-10k pull-up resistor on data line");
+    // One capture channel per sensor, so all frames are recorded at the same time
+    for (size_t i = 0; i < num_sensors; i++) {
+        dht11_sensor_t *sensor = &dht11_state.sensors[i];
+        memset(sensor, 0, sizeof(*sensor));
+        sensor->gpio_num = gpio_nums[i];
+
+        err = gpio_isr_handler_add(sensor->gpio_num, dht11_edge_isr, sensor);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add GPIO %d edge handler: %s", sensor->gpio_num, esp_err_to_name(err));
+            for (size_t j = 0; j < i; j++) {
+                gpio_isr_handler_remove(dht11_state.sensors[j].gpio_num);
+            }
+            goto fail;
+        }
+    }
+
+    dht11_state.num_sensors = num_sensors;
+    dht11_state.frames_done = 0;
+    dht11_state.phase = DHT11_PHASE_IDLE;
+    dht11_state.initialized = true;
+
+    // DHT11 needs ~1s after power-on; reads are refused until then instead of blocking here
+    dht11_state.ready_time_us = esp_timer_get_time() + DHT11_STABILIZATION_TIME_US;
+
+    for (size_t i = 0; i < num_sensors; i++) {
+        ESP_LOGI(TAG, "DHT11 sensor %u on GPIO %d", (unsigned)i, gpio_nums[i]);
+    }
+    ESP_LOGI(TAG, "DHT11 manager initialized with %u sensor(s) (ready in 1s)", (unsigned)num_sensors);
+    ESP_LOGI(TAG, "Ensure each sensor has 4.7k-10k pull-up resistor on data line");
 
     return ESP_OK;
+
+fail:
+    for (size_t i = 0; i < num_sensors; i++) {
+        gpio_reset_pin(gpio_nums[i]);
+    }
+    return err;
 }
 
 esp_err_t dht11_manager_deinit(void)
@@ -202,85 +565,242 @@ esp_err_t dht11_manager_deinit(void)
         ESP_LOGW(TAG, "DHT11 manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
+
+    // Abort any read in progress
+    esp_timer_stop(dht11_state.phase_timer);
+    dht11_state.phase = DHT11_PHASE_IDLE;
     
-    // Reset GPIO
-    if (dht11_state.gpio_num >= 0) {
-        gpio_reset_pin(dht11_state.gpio_num);
-        dht11_state.gpio_num = -1;
+    // Reset GPIOs
+    for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+        dht11_sensor_t *sensor = &dht11_state.sensors[i];
+        gpio_intr_disable(sensor->gpio_num);
+        gpio_isr_handler_remove(sensor->gpio_num);
+        gpio_reset_pin(sensor->gpio_num);
+        sensor->gpio_num = -1;
+        sensor->last_reading.valid = false;
+        sensor->result_pending = false;
     }
     
+    dht11_state.num_sensors = 0;
     dht11_state.initialized = false;
-    dht11_state.last_reading.valid = false;
     
     ESP_LOGI(TAG, "DHT11 manager deinitialized");
     return ESP_OK;
 }
 
-esp_err_t dht11_manager_read(dht11_data_t *data)
+size_t dht11_manager_get_sensor_count(void)
+{
+    return dht11_state.initialized ? dht11_state.num_sensors : 0;
+}
+
+int dht11_manager_get_gpio(size_t sensor_idx)
+{
+    if (!dht11_state.initialized || sensor_idx >= dht11_state.num_sensors) {
+        return -1;
+    }
+    return dht11_state.sensors[sensor_idx].gpio_num;
+}
+
+esp_err_t dht11_manager_start_read(void)
+{
+    if (!dht11_state.initialized) {
+        ESP_LOGE(TAG, "DHT11 manager not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (now_us < dht11_state.ready_time_us) {
+        ESP_LOGD(TAG, "Sensors still stabilizing after power-on");
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    // Claim the cycle; edges from the previous read must not be decoded again
+    bool claimed = false;
+    portENTER_CRITICAL(&dht11_state.lock);
+    if (dht11_state.phase == DHT11_PHASE_IDLE) {
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            dht11_state.sensors[i].edge_count = 0;
+        }
+        dht11_state.frames_done = 0;
+        dht11_state.deadline_us = now_us + DHT11_START_SIGNAL_LOW_TIME + DHT11_CAPTURE_TIMEOUT_US +
+                                  DHT11_CYCLE_SLACK_US;
+        dht11_state.phase = DHT11_PHASE_START_SIGNAL;
+        claimed = true;
+    }
+    portEXIT_CRITICAL(&dht11_state.lock);
+
+    if (!claimed) {
+        ESP_LOGD(TAG, "Read already in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Sensors behind an open breaker are left out and cost nothing
+    size_t num_active = 0;
+    for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+        dht11_sensor_t *sensor = &dht11_state.sensors[i];
+        sensor->active = dht11_breaker_allows(sensor, now_us);
+        if (sensor->active) {
+            num_active++;
+        } else {
+            sensor->stats.skipped++;
+        }
+    }
+
+    if (num_active == 0) {
+        dht11_phase_cas(DHT11_PHASE_START_SIGNAL, DHT11_PHASE_IDLE);
+        return ESP_ERR_NOT_ALLOWED;
+    }
+
+    for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+        dht11_sensor_t *sensor = &dht11_state.sensors[i];
+        if (!sensor->active) {
+            sensor->result.valid = false;
+            sensor->result_err = ESP_ERR_NOT_ALLOWED;
+            sensor->result_pending = true;
+        }
+    }
+    dht11_state.num_active = num_active;
+
+    xSemaphoreTake(dht11_state.capture_done, 0);  // Drop a completion nobody waited for
+
+    // Start signal: hold every line LOW; the phase timer releases them after 18-20ms
+    for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+        if (dht11_state.sensors[i].active) {
+            gpio_set_level(dht11_state.sensors[i].gpio_num, 0);
+        }
+    }
+
+    esp_err_t err = esp_timer_start_once(dht11_state.phase_timer, DHT11_START_SIGNAL_LOW_TIME);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start phase timer: %s", esp_err_to_name(err));
+        for (size_t i = 0; i < dht11_state.num_sensors; i++) {
+            gpio_set_level(dht11_state.sensors[i].gpio_num, 1);
+        }
+        dht11_phase_cas(DHT11_PHASE_START_SIGNAL, DHT11_PHASE_IDLE);
+        return err;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t dht11_manager_poll(size_t sensor_idx, dht11_data_t *data)
 {
     if (!dht11_state.initialized) {
         ESP_LOGE(TAG, "DHT11 manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
     
-    if (data == NULL) {
-        ESP_LOGE(TAG, "Data pointer is NULL");
+    if (sensor_idx >= dht11_state.num_sensors || data == NULL) {
+        ESP_LOGE(TAG, "Invalid sensor index %u or NULL data pointer", (unsigned)sensor_idx);
         return ESP_ERR_INVALID_ARG;
     }
     
-    uint8_t raw_data[5];
-    esp_err_t err;
-    
-    // Disable interrupts during timing-critical read operation
-    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-    portENTER_CRITICAL(&mux);
-    
-    err = dht11_read_raw(raw_data);
-    
-    portEXIT_CRITICAL(&mux);
-    
-    // NOW it's safe to log - interrupts are re-enabled
+    esp_err_t err = dht11_complete_cycle();
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read sensor data (timeout during protocol handshake)");
-        ESP_LOGE(TAG, "Troubleshooting: Check GPIO %d wiring, pull-up resistor (4.7k-10k), and sensor power", 
-                 dht11_state.gpio_num);
-        data->valid = false;
         return err;
     }
-    
-    // Parse and validate data
-    err = dht11_parse_data(raw_data, data);
+
+    return dht11_take_result(&dht11_state.sensors[sensor_idx], data);
+}
+
+esp_err_t dht11_manager_read(size_t sensor_idx, dht11_data_t *data)
+{
+    if (!dht11_state.initialized) {
+        ESP_LOGE(TAG, "DHT11 manager not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sensor_idx >= dht11_state.num_sensors || data == NULL) {
+        ESP_LOGE(TAG, "Invalid sensor index %u or NULL data pointer", (unsigned)sensor_idx);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dht11_sensor_t *sensor = &dht11_state.sensors[sensor_idx];
+    if (dht11_state.phase == DHT11_PHASE_IDLE && !dht11_breaker_allows(sensor, esp_timer_get_time())) {
+        sensor->stats.skipped++;
+        data->valid = false;
+        return ESP_ERR_NOT_ALLOWED;
+    }
+
+    esp_err_t err = dht11_run_cycle();
     if (err != ESP_OK) {
         data->valid = false;
         return err;
     }
-    
-    // Cache last valid reading
-    memcpy(&dht11_state.last_reading, data, sizeof(dht11_data_t));
-    
-    ESP_LOGD(TAG, "Temperature: %.1f°C, Humidity: %.1f%%", 
-             data->temperature, data->humidity);
-    
-    return ESP_OK;
+
+    return dht11_take_result(sensor, data);
 }
 
-esp_err_t dht11_manager_get_cached(dht11_data_t *data)
+esp_err_t dht11_manager_read_all(dht11_data_t *data, size_t count)
 {
     if (!dht11_state.initialized) {
         ESP_LOGE(TAG, "DHT11 manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
     
-    if (data == NULL) {
+    if (data == NULL || count == 0) {
         ESP_LOGE(TAG, "Data pointer is NULL");
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (!dht11_state.last_reading.valid) {
-        ESP_LOGW(TAG, "No valid cached data available");
+    if (count > dht11_state.num_sensors) {
+        count = dht11_state.num_sensors;
+    }
+
+    esp_err_t err = dht11_run_cycle();
+    if (err != ESP_OK) {
+        for (size_t i = 0; i < count; i++) {
+            data[i].valid = false;
+        }
+        return err;
+    }
+
+    // Fill in every sensor but report the first failure
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < count; i++) {
+        err = dht11_take_result(&dht11_state.sensors[i], &data[i]);
+        if (err != ESP_OK && result == ESP_OK) {
+            result = err;
+        }
+    }
+
+    return result;
+}
+
+esp_err_t dht11_manager_get_cached(size_t sensor_idx, dht11_data_t *data)
+{
+    if (!dht11_state.initialized) {
+        ESP_LOGE(TAG, "DHT11 manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
     
-    memcpy(data, &dht11_state.last_reading, sizeof(dht11_data_t));
+    if (sensor_idx >= dht11_state.num_sensors || data == NULL) {
+        ESP_LOGE(TAG, "Invalid sensor index %u or NULL data pointer", (unsigned)sensor_idx);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const dht11_sensor_t *sensor = &dht11_state.sensors[sensor_idx];
+    if (!sensor->last_reading.valid) {
+        ESP_LOGD(TAG, "No valid cached data available for GPIO %d", sensor->gpio_num);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memcpy(data, &sensor->last_reading, sizeof(dht11_data_t));
+    return ESP_OK;
+}
+
+esp_err_t dht11_manager_get_stats(size_t sensor_idx, dht11_stats_t *stats)
+{
+    if (!dht11_state.initialized) {
+        ESP_LOGE(TAG, "DHT11 manager not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sensor_idx >= dht11_state.num_sensors || stats == NULL) {
+        ESP_LOGE(TAG, "Invalid sensor index %u or NULL stats pointer", (unsigned)sensor_idx);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(stats, &dht11_state.sensors[sensor_idx].stats, sizeof(dht11_stats_t));
     return ESP_OK;
 }
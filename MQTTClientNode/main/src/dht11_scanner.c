@@ -0,0 +1,322 @@
+#include "dht11_scanner.h"
+#include "dht11_decoder.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "DHT11_SCANNER";
+
+// NVS location of the detected pins
+#define DHT11_NVS_NAMESPACE           "dht11"
+#define DHT11_NVS_KEY_GPIOS           "gpios"
+
+// Probe timing (microseconds)
+#define DHT11_PROBE_STABILIZATION_US  1000000  // DHT11 needs ~1s after power-on
+#define DHT11_PROBE_START_LOW_MS      20       // Start signal, 18ms min
+#define DHT11_PROBE_WINDOW_US         400      // Response ends ~200us after release
+#define DHT11_PROBE_PULSE_MIN_US      50       // Response LOW / HIGH are ~80us each
+#define DHT11_PROBE_PULSE_MAX_US      120
+
+#define DHT11_PROBE_MAX_PINS          34       // Output-capable pins are 0-33
+#define DHT11_PROBE_MAX_EDGES         8        // Release, the response's 3 edges, glitch headroom
+
+// Per-pin response tracker
+typedef enum {
+    PROBE_WAIT_LOW,      // Line released, waiting for the sensor to pull it LOW
+    PROBE_RESPONSE_LOW,  // In the ~80us response LOW
+    PROBE_RESPONSE_HIGH, // In the ~80us response HIGH
+    PROBE_FOUND,
+    PROBE_REJECTED
+} probe_state_t;
+
+typedef struct {
+    probe_state_t state;
+    uint32_t edge_us;    // Time of the last transition
+} probe_pin_t;
+
+// Per-pin edge capture, filled by the GPIO ISR
+typedef struct {
+    int gpio_num;
+    volatile uint32_t edge_count;
+    dht11_edge_t edges[DHT11_PROBE_MAX_EDGES];
+} probe_capture_t;
+
+static probe_capture_t probe_captures[DHT11_PROBE_MAX_PINS];
+static portMUX_TYPE probe_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief GPIO edge ISR: timestamp the first transitions on one candidate line
+ * 
+ * Same capture as the DHT11 manager's: the response is timed from edge
+ * timestamps, so no task has to poll the lines with interrupts off.
+ * 
+ * @param arg The probe_capture_t of the line
+ */
+static void IRAM_ATTR probe_edge_isr(void *arg)
+{
+    probe_capture_t *capture = (probe_capture_t *)arg;
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    int level = gpio_get_level(capture->gpio_num);
+
+    portENTER_CRITICAL_ISR(&probe_lock);
+    uint32_t idx = capture->edge_count;
+    if (idx < DHT11_PROBE_MAX_EDGES) {
+        capture->edges[idx].time_us = now_us;
+        capture->edges[idx].level = (uint8_t)level;
+        capture->edge_count = idx + 1;
+    }
+    portEXIT_CRITICAL_ISR(&probe_lock);
+}
+
+// Advance one pin's tracker with a new sample
+static inline void probe_update(probe_pin_t *pin, int level, uint32_t now_us)
+{
+    uint32_t width = now_us - pin->edge_us;
+
+    switch (pin->state) {
+    case PROBE_WAIT_LOW:
+        if (!level) {
+            pin->state = PROBE_RESPONSE_LOW;
+            pin->edge_us = now_us;
+        }
+        break;
+
+    case PROBE_RESPONSE_LOW:
+        if (level) {
+            pin->state = (width >= DHT11_PROBE_PULSE_MIN_US && width <= DHT11_PROBE_PULSE_MAX_US)
+                         ? PROBE_RESPONSE_HIGH : PROBE_REJECTED;
+            pin->edge_us = now_us;
+        } else if (width > DHT11_PROBE_PULSE_MAX_US) {
+            pin->state = PROBE_REJECTED;  // Held LOW: shorted or driven by something else
+        }
+        break;
+
+    case PROBE_RESPONSE_HIGH:
+        if (!level) {
+            pin->state = (width >= DHT11_PROBE_PULSE_MIN_US && width <= DHT11_PROBE_PULSE_MAX_US)
+                         ? PROBE_FOUND : PROBE_REJECTED;
+        } else if (width > DHT11_PROBE_PULSE_MAX_US) {
+            pin->state = PROBE_REJECTED;
+        }
+        break;
+
+    case PROBE_FOUND:
+    case PROBE_REJECTED:
+        break;
+    }
+}
+
+// Replay a line's captured edges through the tracker. The final sample
+// (level and time after the window) catches a line stuck in a pulse.
+static probe_state_t probe_evaluate(const probe_capture_t *capture, int final_level, uint32_t final_us)
+{
+    probe_pin_t pin = {
+        .state = PROBE_WAIT_LOW,
+        .edge_us = 0
+    };
+    uint32_t count = capture->edge_count;
+    for (uint32_t i = 0; i < count; i++) {
+        probe_update(&pin, capture->edges[i].level, capture->edges[i].time_us);
+    }
+    if (count < DHT11_PROBE_MAX_EDGES) {
+        probe_update(&pin, final_level, final_us);
+    }
+    return pin.state;
+}
+
+// Helper: Detach the edge handlers of the first n candidates
+static void probe_detach(const int *candidates, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        gpio_intr_disable(candidates[i]);
+        gpio_isr_handler_remove(candidates[i]);
+    }
+}
+
+esp_err_t dht11_scanner_probe(const int *candidates, size_t num_candidates,
+                              int *found, size_t max_found, size_t *num_found)
+{
+    if (candidates == NULL || found == NULL || num_found == NULL ||
+        num_candidates == 0 || num_candidates > DHT11_PROBE_MAX_PINS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *num_found = 0;
+
+    uint64_t pin_mask = 0;
+    for (size_t i = 0; i < num_candidates; i++) {
+        if (candidates[i] < 0 || candidates[i] >= DHT11_PROBE_MAX_PINS) {
+            ESP_LOGE(TAG, "GPIO %d cannot drive a DHT11 start signal", candidates[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+        pin_mask |= 1ULL << candidates[i];
+    }
+
+    // A sensor powered up together with the board ignores start signals for ~1s
+    int64_t wait_us = DHT11_PROBE_STABILIZATION_US - esp_timer_get_time();
+    if (wait_us > 0) {
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000) + 1);
+    }
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = pin_mask,
+        .mode = GPIO_MODE_INPUT_OUTPUT_OD,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_ANYEDGE
+    };
+    esp_err_t err = gpio_config(&io_conf);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure probe GPIOs: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // The ISR service may already be installed by another module
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s", esp_err_to_name(err));
+        goto done;
+    }
+
+    for (size_t i = 0; i < num_candidates; i++) {
+        probe_captures[i].gpio_num = candidates[i];
+        probe_captures[i].edge_count = 0;
+        err = gpio_isr_handler_add(candidates[i], probe_edge_isr, &probe_captures[i]);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add GPIO %d edge handler: %s", candidates[i], esp_err_to_name(err));
+            probe_detach(candidates, i);
+            goto done;
+        }
+    }
+
+    ESP_LOGI(TAG, "Probing %u GPIOs for DHT11 sensors...", (unsigned)num_candidates);
+
+    // One start signal for every candidate
+    for (size_t i = 0; i < num_candidates; i++) {
+        gpio_set_level(candidates[i], 0);
+    }
+    vTaskDelay(pdMS_TO_TICKS(DHT11_PROBE_START_LOW_MS) + 1);
+
+    // Forget the falling edges of the start signal, then release all lines;
+    // the ISRs timestamp each sensor's response
+    portENTER_CRITICAL(&probe_lock);
+    for (size_t i = 0; i < num_candidates; i++) {
+        probe_captures[i].edge_count = 0;
+    }
+    portEXIT_CRITICAL(&probe_lock);
+    for (size_t i = 0; i < num_candidates; i++) {
+        gpio_set_level(candidates[i], 1);
+    }
+    // Busy-wait: a one-tick vTaskDelay can return right after the release
+    esp_rom_delay_us(DHT11_PROBE_WINDOW_US);
+
+    probe_detach(candidates, num_candidates);
+    uint32_t end_us = (uint32_t)esp_timer_get_time();
+
+    for (size_t i = 0; i < num_candidates; i++) {
+        probe_state_t state = probe_evaluate(&probe_captures[i], gpio_get_level(candidates[i]), end_us);
+        if (state != PROBE_FOUND) {
+            continue;
+        }
+        ESP_LOGI(TAG, "DHT11 response on GPIO %d", candidates[i]);
+        if (*num_found < max_found) {
+            found[(*num_found)++] = candidates[i];
+        } else {
+            ESP_LOGW(TAG, "Ignoring DHT11 on GPIO %d (max %u sensors)", candidates[i], (unsigned)max_found);
+        }
+    }
+
+    err = *num_found > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+    if (err == ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "No DHT11 sensor answered on any candidate GPIO");
+    }
+
+done:
+    // Hand the pins back untouched so the DHT11 manager can claim them
+    for (size_t i = 0; i < num_candidates; i++) {
+        gpio_reset_pin(candidates[i]);
+    }
+    return err;
+}
+
+esp_err_t dht11_scanner_load_cached(int *gpios, size_t max_gpios, size_t *num_gpios)
+{
+    if (gpios == NULL || num_gpios == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *num_gpios = 0;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(DHT11_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;  // Namespace does not exist before the first save
+    }
+
+    uint8_t cached[DHT11_PROBE_MAX_PINS];
+    size_t len = sizeof(cached);
+    err = nvs_get_blob(handle, DHT11_NVS_KEY_GPIOS, cached, &len);
+    nvs_close(handle);
+    if (err != ESP_OK || len == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    for (size_t i = 0; i < len && *num_gpios < max_gpios; i++) {
+        gpios[(*num_gpios)++] = cached[i];
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t dht11_scanner_save_cached(const int *gpios, size_t num_gpios)
+{
+    if (gpios == NULL || num_gpios == 0 || num_gpios > DHT11_PROBE_MAX_PINS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t cached[DHT11_PROBE_MAX_PINS];
+    for (size_t i = 0; i < num_gpios; i++) {
+        cached[i] = (uint8_t)gpios[i];
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(DHT11_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(handle, DHT11_NVS_KEY_GPIOS, cached, num_gpios);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store DHT11 GPIOs: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t dht11_scanner_clear_cached(void)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(DHT11_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = nvs_erase_key(handle, DHT11_NVS_KEY_GPIOS);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_OK;
+    }
+    nvs_close(handle);
+
+    return err;
+}
@@ -0,0 +1,182 @@
+#include "diagnostics.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "json_writer.h"
+#include "latency_stats.h"
+#include "mqtt_manager.h"
+#include "mqtt_publisher.h"
+#include "mqtt_tls.h"
+#include "mqtt_broker.h"
+
+static const char *TAG = "DIAGNOSTICS";
+
+// Report buffer, reused by every report (reports come from a single job)
+static char diag_buf[CONFIG_DIAG_PAYLOAD_MAX];
+
+// Start of the current latency window
+static int64_t window_start_us = 0;
+
+esp_err_t diagnostics_publish(void)
+{
+    if (!mqtt_manager_is_connected()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+
+    json_writer_t w;
+    json_writer_init(&w, diag_buf, sizeof(diag_buf));
+    json_writer_begin_object(&w);
+
+    json_writer_key(&w, "client_id");
+    json_writer_string(&w, CONFIG_MQTT_CLIENT_ID);
+    json_writer_key(&w, "uptime_s");
+    json_writer_int(&w, (int32_t)(now_us / 1000000));
+    json_writer_key(&w, "window_s");
+    json_writer_int(&w, (int32_t)((now_us - window_start_us) / 1000000));
+
+    json_writer_key(&w, "latency");
+    json_writer_begin_object(&w);
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        latency_summary_t s;
+        latency_get_summary((latency_stage_t)stage, &s);
+        if (s.count == 0) {
+            continue;
+        }
+        json_writer_key(&w, latency_stage_name((latency_stage_t)stage));
+        json_writer_begin_object(&w);
+        json_writer_key(&w, "n");
+        json_writer_int(&w, (int32_t)s.count);
+        json_writer_key(&w, "p50_us");
+        json_writer_int(&w, (int32_t)s.p50_us);
+        json_writer_key(&w, "p95_us");
+        json_writer_int(&w, (int32_t)s.p95_us);
+        json_writer_key(&w, "max_us");
+        json_writer_int(&w, (int32_t)s.max_us);
+        json_writer_key(&w, "mean_us");
+        json_writer_int(&w, (int32_t)s.mean_us);
+        json_writer_end_object(&w);
+    }
+    json_writer_end_object(&w);
+
+    mqtt_manager_stats_t mqtt;
+    mqtt_publisher_stats_t pub;
+    mqtt_manager_get_stats(&mqtt);
+    mqtt_publisher_get_stats(&pub);
+
+    json_writer_key(&w, "mqtt");
+    json_writer_begin_object(&w);
+    json_writer_key(&w, "inflight");
+    json_writer_int(&w, (int32_t)mqtt.inflight);
+    json_writer_key(&w, "inflight_peak");
+    json_writer_int(&w, (int32_t)mqtt.inflight_peak);
+    json_writer_key(&w, "acked");
+    json_writer_int(&w, (int32_t)mqtt.acked);
+    json_writer_key(&w, "expired");
+    json_writer_int(&w, (int32_t)mqtt.expired);
+    json_writer_key(&w, "rejected");
+    json_writer_int(&w, (int32_t)mqtt.rejected);
+    json_writer_key(&w, "outbox_bytes");
+    json_writer_int(&w, (int32_t)mqtt.outbox_bytes);
+    json_writer_key(&w, "queued");
+    json_writer_int(&w, (int32_t)mqtt.queue.count);
+    json_writer_key(&w, "queued_bytes");
+    json_writer_int(&w, (int32_t)mqtt.queue.bytes);
+    json_writer_key(&w, "queued_peak_bytes");
+    json_writer_int(&w, (int32_t)mqtt.queue.peak_bytes);
+    json_writer_key(&w, "queue_dropped");
+    json_writer_int(&w, (int32_t)mqtt.queue.dropped);
+    json_writer_key(&w, "queue_coalesced");
+    json_writer_int(&w, (int32_t)mqtt.queue.coalesced);
+    json_writer_key(&w, "protocol");
+    json_writer_string(&w, mqtt.protocol_v5 ? "5" : "3.1.1");
+    json_writer_key(&w, "reconnects");
+    json_writer_int(&w, (int32_t)mqtt.reconnects);
+    json_writer_key(&w, "reconnect_attempts");
+    json_writer_int(&w, (int32_t)mqtt.reconnect_attempts);
+    json_writer_key(&w, "last_reconnect_ms");
+    json_writer_int(&w, (int32_t)mqtt.last_reconnect_ms);
+    json_writer_key(&w, "max_reconnect_ms");
+    json_writer_int(&w, (int32_t)mqtt.max_reconnect_ms);
+    json_writer_key(&w, "sessions_resumed");
+    json_writer_int(&w, (int32_t)mqtt.sessions_resumed);
+    json_writer_key(&w, "broker");
+    json_writer_int(&w, (int32_t)mqtt.active_broker);
+    json_writer_key(&w, "failovers");
+    json_writer_int(&w, (int32_t)mqtt.failovers);
+    json_writer_key(&w, "failbacks");
+    json_writer_int(&w, (int32_t)mqtt.failbacks);
+    json_writer_key(&w, "last_failover_ms");
+    json_writer_int(&w, (int32_t)mqtt.last_failover_ms);
+    json_writer_key(&w, "max_failover_ms");
+    json_writer_int(&w, (int32_t)mqtt.max_failover_ms);
+    json_writer_key(&w, "pressure");
+    json_writer_int(&w, (int32_t)mqtt_manager_get_pressure());
+    json_writer_key(&w, "stretch");
+    json_writer_int(&w, (int32_t)pub.stretch);
+    json_writer_key(&w, "coalesced");
+    json_writer_int(&w, (int32_t)pub.coalesced);
+    json_writer_key(&w, "downgraded");
+    json_writer_int(&w, (int32_t)pub.downgraded);
+    json_writer_end_object(&w);
+
+    // Per-broker health, only worth reporting with backups configured
+    if (mqtt_broker_count() > 1) {
+        json_writer_key(&w, "brokers");
+        json_writer_begin_array(&w);
+        for (int i = 0; i < (int)mqtt_broker_count(); i++) {
+            mqtt_broker_info_t b;
+            mqtt_broker_get_info(i, &b);
+            json_writer_begin_object(&w);
+            json_writer_key(&w, "healthy");
+            json_writer_bool(&w, b.healthy);
+            json_writer_key(&w, "rtt_ms");
+            json_writer_int(&w, (int32_t)b.rtt_ms);
+            json_writer_key(&w, "puback_ms");
+            json_writer_int(&w, (int32_t)b.puback_ms);
+            json_writer_key(&w, "probe_failures");
+            json_writer_int(&w, (int32_t)b.probe_failures);
+            json_writer_end_object(&w);
+        }
+        json_writer_end_array(&w);
+    }
+
+#if CONFIG_MQTT_TLS_ENABLED
+    mqtt_tls_stats_t tls;
+    mqtt_tls_get_stats(&tls);
+
+    json_writer_key(&w, "tls");
+    json_writer_begin_object(&w);
+    json_writer_key(&w, "full");
+    json_writer_int(&w, (int32_t)tls.full);
+    json_writer_key(&w, "resumed");
+    json_writer_int(&w, (int32_t)tls.resumed);
+    json_writer_key(&w, "failures");
+    json_writer_int(&w, (int32_t)tls.failures);
+    json_writer_key(&w, "full_heap_peak");
+    json_writer_int(&w, (int32_t)tls.full_heap_peak);
+    json_writer_key(&w, "resumed_heap_peak");
+    json_writer_int(&w, (int32_t)tls.resumed_heap_peak);
+    json_writer_key(&w, "session_cached");
+    json_writer_bool(&w, tls.session_cached != 0);
+    json_writer_end_object(&w);
+#endif
+
+    json_writer_end_object(&w);
+    size_t len = json_writer_finish(&w);
+    if (len == 0) {
+        ESP_LOGE(TAG, "Diagnostics report exceeds %d bytes", CONFIG_DIAG_PAYLOAD_MAX);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // QoS 0: a lost report is replaced by the next one
+    if (mqtt_manager_publish_bin(CONFIG_MQTT_DIAG_TOPIC, diag_buf, len, 0, 0) == -1) {
+        return ESP_FAIL;
+    }
+
+    ESP_LOGD(TAG, "Diagnostics: %s", diag_buf);
+    latency_reset();
+    window_start_us = now_us;
+    return ESP_OK;
+}
@@ -4,31 +4,151 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "HYGROMETER_MANAGER";
 
-// Manager state
+// Per-probe state
 typedef struct {
-    bool initialized;
     int gpio_num;
-    int dry_value;   // ADC value when dry (air) - typically higher voltage
-    int wet_value;   // ADC value when wet (water) - typically lower voltage
+    int dry_value;          // ADC value when dry (air) - typically higher voltage
+    int wet_value;          // ADC value when wet (water) - typically lower voltage
+    uint32_t scale_q16;     // 10000 / (dry - wet) in Q16: raw -> hundredths of a percent
+    const uint16_t *lut;    // Moisture of codes lut_base.., NULL if the table pool is full
+    int lut_base;
+    int lut_len;
     hygrometer_data_t last_reading;
+} hygrometer_probe_t;
+
+// Manager state
+typedef struct {
+    bool initialized;
+    size_t num_probes;
+    int gpios[CONFIG_HYGROMETER_MAX_PROBES];  // Probe GPIOs, in probe order (one ADC read group)
+    hygrometer_probe_t probes[CONFIG_HYGROMETER_MAX_PROBES];
+    SemaphoreHandle_t lut_lock;     // Calibration and tables vs conversions (a rebuild repacks every probe)
 } hygrometer_state_t;
 
 static hygrometer_state_t hygro_state = {
     .initialized = false,
-    .gpio_num = -1,
-    .dry_value = CONFIG_HYGROMETER_DRY_VALUE,
-    .wet_value = CONFIG_HYGROMETER_WET_VALUE,
-    .last_reading = {0}
+    .num_probes = 0,
+    .lut_lock = NULL
 };
 
-esp_err_t hygrometer_manager_init(int gpio_num)
+// Raw -> moisture tables of all probes, packed in probe order. A table only
+// covers the codes strictly between its probe's wet and dry values: codes
+// outside clamp to 100% / 0% without a lookup.
+static uint16_t hygro_lut_pool[CONFIG_HYGROMETER_LUT_ENTRIES];
+
+/**
+ * @brief Precompute a probe's raw -> moisture scale from its dry/wet calibration
+ * 
+ * Most soil moisture sensors read higher voltage when dry, lower when wet,
+ * so dry_value maps to 0% and wet_value to 100%, clamped outside that range.
+ * The scale fills the probe's lookup table (see hygrometer_build_luts()).
+ */
+static void hygrometer_set_scale(hygrometer_probe_t *probe, int dry_value, int wet_value)
+{
+    int range = dry_value - wet_value;
+
+    probe->dry_value = dry_value;
+    probe->wet_value = wet_value;
+    probe->scale_q16 = range > 0 ? (uint32_t)(((10000u << 16) + range / 2) / range) : 0;
+}
+
+// Convert a raw code to hundredths of a percent by multiply (no float math)
+static uint16_t hygrometer_scale_moisture(const hygrometer_probe_t *probe, int raw)
+{
+    int delta = probe->dry_value - raw;
+    if (delta <= 0 || probe->scale_q16 == 0) {
+        return 0;
+    }
+
+    uint32_t moisture = (uint32_t)(((uint64_t)delta * probe->scale_q16 + 0x8000) >> 16);
+    return moisture > 10000 ? 10000 : (uint16_t)moisture;
+}
+
+/**
+ * @brief Rebuild the raw -> moisture tables of all probes
+ * 
+ * Each probe gets dry - wet - 1 entries of the shared pool (about 2.6KB for a
+ * typical 1300-code span, against 8KB for a table of every code), in probe
+ * order. A probe that no longer fits keeps converting by multiply, with the
+ * same results. Caller holds lut_lock once the manager is initialized.
+ */
+static void hygrometer_build_luts(void)
+{
+    size_t used = 0;
+    for (size_t i = 0; i < hygro_state.num_probes; i++) {
+        hygrometer_probe_t *probe = &hygro_state.probes[i];
+        probe->lut = NULL;
+        if (probe->scale_q16 == 0) {
+            continue;  // Invalid calibration: always 0%
+        }
+
+        // Codes strictly between wet and dry, within the ADC range
+        int first = probe->wet_value + 1 > 0 ? probe->wet_value + 1 : 0;
+        int last = probe->dry_value - 1 < ADC_SCANNER_RAW_CODES - 1 ? probe->dry_value - 1 : ADC_SCANNER_RAW_CODES - 1;
+        if (last < first) {
+            continue;
+        }
+        size_t len = (size_t)(last - first + 1);
+        if (used + len > CONFIG_HYGROMETER_LUT_ENTRIES) {
+            ESP_LOGW(TAG, "No lookup table room for GPIO %d (%u entries), converting by multiply",
+                     probe->gpio_num, (unsigned)len);
+            continue;
+        }
+
+        uint16_t *lut = &hygro_lut_pool[used];
+        for (size_t k = 0; k < len; k++) {
+            lut[k] = hygrometer_scale_moisture(probe, first + (int)k);
+        }
+        probe->lut_base = first;
+        probe->lut_len = (int)len;
+        probe->lut = lut;
+        used += len;
+    }
+}
+
+// Convert a raw code to hundredths of a percent (single table load)
+static inline uint16_t hygrometer_raw_to_moisture(const hygrometer_probe_t *probe, int raw)
+{
+    if (probe->scale_q16 == 0 || raw >= probe->dry_value) {
+        return 0;
+    }
+    if (raw <= probe->wet_value) {
+        return 10000;
+    }
+    if (probe->lut && raw >= probe->lut_base && raw < probe->lut_base + probe->lut_len) {
+        return probe->lut[raw - probe->lut_base];
+    }
+    return hygrometer_scale_moisture(probe, raw);
+}
+
+// Store a filtered ADC reading as the probe's latest result
+static void hygrometer_store(hygrometer_probe_t *probe, int raw_value, int voltage_mv,
+                             hygrometer_data_t *data)
+{
+    data->raw_value = raw_value;
+    data->voltage_mv = voltage_mv;
+    xSemaphoreTake(hygro_state.lut_lock, portMAX_DELAY);
+    data->moisture_x100 = hygrometer_raw_to_moisture(probe, raw_value);
+    xSemaphoreGive(hygro_state.lut_lock);
+    data->valid = true;
+
+    // Cache the reading
+    memcpy(&probe->last_reading, data, sizeof(hygrometer_data_t));
+
+    ESP_LOGD(TAG, "Hygrometer GPIO %d read: Raw=%d, Voltage=%d mV, Moisture=%u.%02u%%",
+             probe->gpio_num, raw_value, voltage_mv,
+             data->moisture_x100 / 100, data->moisture_x100 % 100);
+}
+
+esp_err_t hygrometer_manager_init(const hygrometer_probe_config_t *probes, size_t num_probes)
 {
-    if (gpio_num < 0 || gpio_num > 39) {
-        ESP_LOGE(TAG, "Invalid GPIO number: %d", gpio_num);
+    if (probes == NULL || num_probes == 0 || num_probes > CONFIG_HYGROMETER_MAX_PROBES) {
+        ESP_LOGE(TAG, "Invalid probe list (1..%d probes supported)", CONFIG_HYGROMETER_MAX_PROBES);
         return ESP_ERR_INVALID_ARG;
     }
 
@@ -37,30 +157,78 @@ esp_err_t hygrometer_manager_init(int gpio_num)
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Verify GPIO is an ADC1 channel (compatible with WiFi)
-    // ADC1: GPIO 32-39
-    if (gpio_num < 32 || gpio_num > 39) {
-        ESP_LOGE(TAG, "GPIO %d is not an ADC1 channel. Use GPIO 32-39 only.", gpio_num);
-        ESP_LOGE(TAG, "ADC2 channels cannot be used while WiFi is active.");
-        return ESP_ERR_INVALID_ARG;
+    for (size_t i = 0; i < num_probes; i++) {
+        int gpio_num = probes[i].gpio_num;
+
+        // Verify GPIO is an ADC1 channel (compatible with WiFi)
+        // ADC1: GPIO 32-39
+        if (gpio_num < 32 || gpio_num > 39) {
+            ESP_LOGE(TAG, "GPIO %d is not an ADC1 channel. Use GPIO 32-39 only.", gpio_num);
+            ESP_LOGE(TAG, "ADC2 channels cannot be used while WiFi is active.");
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        for (size_t j = 0; j < i; j++) {
+            if (probes[j].gpio_num == gpio_num) {
+                ESP_LOGE(TAG, "GPIO %d is listed for more than one probe", gpio_num);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
     }
 
-    hygro_state.gpio_num = gpio_num;
+    if (hygro_state.lut_lock == NULL) {
+        hygro_state.lut_lock = xSemaphoreCreateMutex();
+        if (hygro_state.lut_lock == NULL) {
+            ESP_LOGE(TAG, "Failed to create table lock");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    for (size_t i = 0; i < num_probes; i++) {
+        hygrometer_probe_t *probe = &hygro_state.probes[i];
+        memset(probe, 0, sizeof(*probe));
+        probe->gpio_num = probes[i].gpio_num;
+        hygro_state.gpios[i] = probes[i].gpio_num;
+
+        if (probes[i].dry_value <= probes[i].wet_value) {
+            ESP_LOGW(TAG, "Invalid calibration on GPIO %d: dry_value must be > wet_value, moisture will read 0%%",
+                     probe->gpio_num);
+        }
+        hygrometer_set_scale(probe, probes[i].dry_value, probes[i].wet_value);
+    }
+    hygro_state.num_probes = num_probes;
+    hygrometer_build_luts();
     hygro_state.initialized = true;
-    hygro_state.last_reading.valid = false;
 
-    ESP_LOGI(TAG, "Hygrometer manager initialized on GPIO %d", gpio_num);
-    ESP_LOGI(TAG, "Calibration: Dry=%d (0%%), Wet=%d (100%%)", 
-             hygro_state.dry_value, hygro_state.wet_value);
+#if CONFIG_ADC_CONTINUOUS_ENABLED
+    // Sample every ADC1 channel in the background so reads never block on ADC
+    // conversions and presence sweeps come for free; all probes share the
+    // same interleaved conversion pattern
+    esp_err_t cont_ret = adc_scanner_continuous_start(NULL, 0);
+    if (cont_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Continuous sampling unavailable (%s), using one-shot reads", 
+                 esp_err_to_name(cont_ret));
+    }
+#endif
+
+    for (size_t i = 0; i < num_probes; i++) {
+        ESP_LOGI(TAG, "Hygrometer probe %u on GPIO %d, calibration: Dry=%d (0%%), Wet=%d (100%%)",
+                 (unsigned)i, hygro_state.probes[i].gpio_num,
+                 hygro_state.probes[i].dry_value, hygro_state.probes[i].wet_value);
+    }
     
     // Perform initial reading
-    hygrometer_data_t initial_data;
-    esp_err_t ret = hygrometer_manager_read(&initial_data);
-    if (ret == ESP_OK && initial_data.valid) {
-        ESP_LOGI(TAG, "Initial reading: %d mV (%.1f%% moisture)", 
-                 initial_data.voltage_mv, initial_data.moisture_percent);
-    } else {
-        ESP_LOGW(TAG, "Initial reading failed, sensor may not be connected");
+    hygrometer_data_t initial_data[CONFIG_HYGROMETER_MAX_PROBES] = {0};
+    hygrometer_manager_read_all(initial_data, num_probes);
+    for (size_t i = 0; i < num_probes; i++) {
+        if (initial_data[i].valid) {
+            ESP_LOGI(TAG, "Initial reading GPIO %d: %d mV (%u.%02u%% moisture)",
+                     hygro_state.probes[i].gpio_num, initial_data[i].voltage_mv,
+                     initial_data[i].moisture_x100 / 100, initial_data[i].moisture_x100 % 100);
+        } else {
+            ESP_LOGW(TAG, "Initial reading failed on GPIO %d, sensor may not be connected",
+                     hygro_state.probes[i].gpio_num);
+        }
     }
 
     return ESP_OK;
@@ -69,106 +237,147 @@ esp_err_t hygrometer_manager_init(int gpio_num)
 void hygrometer_manager_deinit(void)
 {
     if (hygro_state.initialized) {
+        adc_scanner_continuous_stop();
         hygro_state.initialized = false;
-        hygro_state.gpio_num = -1;
+        hygro_state.num_probes = 0;
         ESP_LOGI(TAG, "Hygrometer manager deinitialized");
     }
 }
 
-esp_err_t hygrometer_manager_read(hygrometer_data_t *data)
+size_t hygrometer_manager_get_probe_count(void)
+{
+    return hygro_state.initialized ? hygro_state.num_probes : 0;
+}
+
+int hygrometer_manager_get_gpio(size_t probe_idx)
+{
+    if (!hygro_state.initialized || probe_idx >= hygro_state.num_probes) {
+        return -1;
+    }
+    return hygro_state.probes[probe_idx].gpio_num;
+}
+
+esp_err_t hygrometer_manager_read(size_t probe_idx, hygrometer_data_t *data)
 {
     if (!hygro_state.initialized) {
         ESP_LOGE(TAG, "Hygrometer manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (!data) {
+    if (!data || probe_idx >= hygro_state.num_probes) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Read ADC (multi-sample average)
+    hygrometer_probe_t *probe = &hygro_state.probes[probe_idx];
+
+    // Read ADC (outlier-rejecting streaming filter)
     int raw_value = 0;
     int voltage_mv = 0;
-    esp_err_t ret = adc_scanner_read_gpio(hygro_state.gpio_num, &raw_value, &voltage_mv, 
-                                          CONFIG_HYGROMETER_NUM_SAMPLES);
+    esp_err_t ret = adc_scanner_read_filtered(probe->gpio_num, &raw_value, &voltage_mv,
+                                              CONFIG_HYGROMETER_NUM_SAMPLES);
     
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to read ADC on GPIO %d: %s", 
-                 hygro_state.gpio_num, esp_err_to_name(ret));
+                 probe->gpio_num, esp_err_to_name(ret));
         data->valid = false;
         return ret;
     }
 
-    // Store raw values
-    data->raw_value = raw_value;
-    data->voltage_mv = voltage_mv;
-    data->valid = true;
+    hygrometer_store(probe, raw_value, voltage_mv, data);
+    return ESP_OK;
+}
 
-    // Calculate moisture percentage using calibration
-    // Most soil moisture sensors read higher voltage when dry, lower when wet
-    // So: 0% moisture = dry_value, 100% moisture = wet_value
-    
-    int range = hygro_state.dry_value - hygro_state.wet_value;
-    if (range <= 0) {
-        ESP_LOGW(TAG, "Invalid calibration: dry_value must be > wet_value");
-        data->moisture_percent = 0.0f;
-    } else {
-        // Map: dry_value -> 0%, wet_value -> 100%
-        float percent = ((float)(hygro_state.dry_value - raw_value) / (float)range) * 100.0f;
-        
-        // Clamp to 0-100%
-        if (percent < 0.0f) percent = 0.0f;
-        if (percent > 100.0f) percent = 100.0f;
-        
-        data->moisture_percent = percent;
+esp_err_t hygrometer_manager_read_all(hygrometer_data_t *data, size_t count)
+{
+    if (!hygro_state.initialized) {
+        ESP_LOGE(TAG, "Hygrometer manager not initialized");
+        return ESP_ERR_INVALID_STATE;
     }
 
-    // Cache the reading
-    memcpy(&hygro_state.last_reading, data, sizeof(hygrometer_data_t));
+    if (!data || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    ESP_LOGD(TAG, "Hygrometer read: Raw=%d, Voltage=%d mV, Moisture=%.1f%%", 
-             raw_value, voltage_mv, data->moisture_percent);
+    if (count > hygro_state.num_probes) {
+        count = hygro_state.num_probes;
+    }
 
-    return ESP_OK;
+    // All probes in one conversion sequence: acquisition time does not grow
+    // with the number of probes
+    int raw_values[CONFIG_HYGROMETER_MAX_PROBES];
+    int voltages_mv[CONFIG_HYGROMETER_MAX_PROBES];
+    for (size_t i = 0; i < count; i++) {
+        raw_values[i] = -1;  // Stays -1 for probes whose filter is still filling
+    }
+
+    esp_err_t ret = adc_scanner_read_filtered_group(hygro_state.gpios, count, raw_values, voltages_mv,
+                                                    CONFIG_HYGROMETER_NUM_SAMPLES);
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_FINISHED) {
+        ESP_LOGE(TAG, "Failed to read hygrometer probes: %s", esp_err_to_name(ret));
+        for (size_t i = 0; i < count; i++) {
+            data[i].valid = false;
+        }
+        return ret;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (raw_values[i] < 0) {
+            data[i].valid = false;
+            continue;
+        }
+        hygrometer_store(&hygro_state.probes[i], raw_values[i], voltages_mv[i], &data[i]);
+    }
+
+    return ret;
 }
 
-esp_err_t hygrometer_manager_get_cached(hygrometer_data_t *data)
+esp_err_t hygrometer_manager_get_cached(size_t probe_idx, hygrometer_data_t *data)
 {
     if (!hygro_state.initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (!data) {
+    if (!data || probe_idx >= hygro_state.num_probes) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (!hygro_state.last_reading.valid) {
-        ESP_LOGD(TAG, "No valid cached data available");
+    if (!hygro_state.probes[probe_idx].last_reading.valid) {
+        ESP_LOGD(TAG, "No valid cached data available for GPIO %d",
+                 hygro_state.probes[probe_idx].gpio_num);
         return ESP_ERR_INVALID_STATE;
     }
 
-    memcpy(data, &hygro_state.last_reading, sizeof(hygrometer_data_t));
+    memcpy(data, &hygro_state.probes[probe_idx].last_reading, sizeof(hygrometer_data_t));
     return ESP_OK;
 }
 
-esp_err_t hygrometer_manager_set_calibration(int dry_value, int wet_value)
+esp_err_t hygrometer_manager_set_calibration(size_t probe_idx, int dry_value, int wet_value)
 {
     if (!hygro_state.initialized) {
         ESP_LOGE(TAG, "Hygrometer manager not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
+    if (probe_idx >= hygro_state.num_probes) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
     if (dry_value <= wet_value) {
         ESP_LOGE(TAG, "Invalid calibration: dry_value (%d) must be > wet_value (%d)", 
                  dry_value, wet_value);
         return ESP_ERR_INVALID_ARG;
     }
 
-    hygro_state.dry_value = dry_value;
-    hygro_state.wet_value = wet_value;
+    // The sampler converts readings concurrently: it must not see a half
+    // repacked pool or a probe's old span over another probe's table
+    hygrometer_probe_t *probe = &hygro_state.probes[probe_idx];
+    xSemaphoreTake(hygro_state.lut_lock, portMAX_DELAY);
+    hygrometer_set_scale(probe, dry_value, wet_value);
+    hygrometer_build_luts();  // Spans moved: repack every probe's table
+    xSemaphoreGive(hygro_state.lut_lock);
 
-    ESP_LOGI(TAG, "Calibration updated: Dry=%d (0%%), Wet=%d (100%%)", 
-             dry_value, wet_value);
+    ESP_LOGI(TAG, "Calibration updated for GPIO %d: Dry=%d (0%%), Wet=%d (100%%)",
+             probe->gpio_num, dry_value, wet_value);
 
     return ESP_OK;
 }
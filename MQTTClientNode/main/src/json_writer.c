@@ -0,0 +1,242 @@
+#include "json_writer.h"
+#include <string.h>
+
+// Two ASCII digits per entry: integer formatting does one division per digit pair
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint32_t pow10_table[] = { 1, 10, 100, 1000, 10000 };
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static inline void put_raw(json_writer_t *w, const char *data, size_t n)
+{
+    if (w->overflow || w->len + n >= w->cap) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(&w->buf[w->len], data, n);
+    w->len += n;
+}
+
+static inline void put_char(json_writer_t *w, char c)
+{
+    if (w->overflow || w->len + 1 >= w->cap) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->len++] = c;
+}
+
+// Emit the separator owed before a new value in the current container
+static void begin_value(json_writer_t *w)
+{
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    uint8_t bit = (uint8_t)(1u << w->depth);
+    if (w->need_comma & bit) {
+        put_char(w, ',');
+    }
+    w->need_comma |= bit;
+}
+
+// Format an unsigned value right-aligned into the end of tmp, return its start
+static char *format_u32(char *end, uint32_t value)
+{
+    char *p = end;
+    while (value >= 100) {
+        uint32_t pair = (value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        p[0] = digit_pairs[pair];
+        p[1] = digit_pairs[pair + 1];
+    }
+    if (value >= 10) {
+        p -= 2;
+        p[0] = digit_pairs[value * 2];
+        p[1] = digit_pairs[value * 2 + 1];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    return p;
+}
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0;
+    w->overflow = (buf == NULL || cap == 0);
+    w->depth = 0;
+    w->need_comma = 0;
+    w->after_key = false;
+}
+
+static void open_container(json_writer_t *w, char c)
+{
+    begin_value(w);
+    if (w->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+        w->overflow = true;
+        return;
+    }
+    put_char(w, c);
+    w->depth++;
+    w->need_comma &= (uint8_t)~(1u << w->depth);
+}
+
+static void close_container(json_writer_t *w, char c)
+{
+    if (w->depth == 0) {
+        w->overflow = true;
+        return;
+    }
+    put_char(w, c);
+    w->depth--;
+}
+
+void json_writer_begin_object(json_writer_t *w)
+{
+    open_container(w, '{');
+}
+
+void json_writer_end_object(json_writer_t *w)
+{
+    close_container(w, '}');
+}
+
+void json_writer_begin_array(json_writer_t *w)
+{
+    open_container(w, '[');
+}
+
+void json_writer_end_array(json_writer_t *w)
+{
+    close_container(w, ']');
+}
+
+void json_writer_key(json_writer_t *w, const char *key)
+{
+    begin_value(w);
+    put_char(w, '"');
+    put_raw(w, key, strlen(key));
+    put_raw(w, "\":", 2);
+    w->after_key = true;
+}
+
+void json_writer_string(json_writer_t *w, const char *value)
+{
+    begin_value(w);
+    put_char(w, '"');
+
+    // Copy runs of safe characters in one go, escape the rest
+    const char *run = value;
+    for (const char *p = value; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        put_raw(w, run, (size_t)(p - run));
+        run = p + 1;
+        switch (c) {
+        case '"':  put_raw(w, "\\\"", 2); break;
+        case '\\': put_raw(w, "\\\\", 2); break;
+        case '\n': put_raw(w, "\\n", 2); break;
+        case '\r': put_raw(w, "\\r", 2); break;
+        case '\t': put_raw(w, "\\t", 2); break;
+        default: {
+            char esc[6] = { '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0xF] };
+            put_raw(w, esc, sizeof(esc));
+            break;
+        }
+        }
+    }
+    put_raw(w, run, strlen(run));
+
+    put_char(w, '"');
+}
+
+void json_writer_int(json_writer_t *w, int32_t value)
+{
+    begin_value(w);
+
+    char tmp[12];
+    char *end = tmp + sizeof(tmp);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    char *p = format_u32(end, magnitude);
+    if (value < 0) {
+        *--p = '-';
+    }
+    put_raw(w, p, (size_t)(end - p));
+}
+
+void json_writer_fixed(json_writer_t *w, int32_t value, uint8_t decimals)
+{
+    if (decimals == 0) {
+        json_writer_int(w, value);
+        return;
+    }
+    if (decimals >= sizeof(pow10_table) / sizeof(pow10_table[0])) {
+        decimals = sizeof(pow10_table) / sizeof(pow10_table[0]) - 1;
+    }
+
+    begin_value(w);
+
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    uint32_t scale = pow10_table[decimals];
+    uint32_t whole = magnitude / scale;
+    uint32_t frac = magnitude % scale;
+
+    // Build "-whole.frac" back to front, zero-padding the fraction
+    char tmp[20];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+    for (uint8_t i = 0; i < decimals; i++) {
+        *--p = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    *--p = '.';
+    p = format_u32(p, whole);
+    if (value < 0) {
+        *--p = '-';
+    }
+    put_raw(w, p, (size_t)(end - p));
+}
+
+void json_writer_bool(json_writer_t *w, bool value)
+{
+    begin_value(w);
+    if (value) {
+        put_raw(w, "true", 4);
+    } else {
+        put_raw(w, "false", 5);
+    }
+}
+
+void json_writer_null(json_writer_t *w)
+{
+    begin_value(w);
+    put_raw(w, "null", 4);
+}
+
+size_t json_writer_finish(json_writer_t *w)
+{
+    if (w->overflow || w->depth != 0) {
+        if (w->cap > 0 && w->buf) {
+            w->buf[0] = '\0';
+        }
+        return 0;
+    }
+    w->buf[w->len] = '\0';
+    return w->len;
+}
@@ -0,0 +1,135 @@
+#include "latency_stats.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+// Log-linear buckets: each power-of-two octave of microseconds is split into
+// LATENCY_SUB_BUCKETS equal parts (worst-case error ~12%), from 1us to ~16s.
+// Durations below LATENCY_SUB_BUCKETS us get one bucket each.
+#define LATENCY_SUB_BITS     2
+#define LATENCY_SUB_BUCKETS  (1u << LATENCY_SUB_BITS)
+#define LATENCY_MAX_OCTAVE   23
+#define LATENCY_NUM_BUCKETS  ((LATENCY_MAX_OCTAVE - LATENCY_SUB_BITS + 2) * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    uint32_t buckets[LATENCY_NUM_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+} latency_histogram_t;
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_DHT11_READ] = "dht11_read",
+    [LATENCY_STAGE_ADC_READ]   = "adc_read",
+    [LATENCY_STAGE_TIMESTAMP]  = "timestamp",
+    [LATENCY_STAGE_IP_LOOKUP]  = "ip_lookup",
+    [LATENCY_STAGE_SERIALIZE]  = "serialize",
+    [LATENCY_STAGE_ENQUEUE]    = "enqueue",
+    [LATENCY_STAGE_PUBACK]     = "puback",
+    [LATENCY_STAGE_CYCLE]      = "cycle",
+    [LATENCY_STAGE_TLS_FULL]   = "tls_full",
+    [LATENCY_STAGE_TLS_RESUMED] = "tls_resumed",
+};
+
+static struct {
+    latency_histogram_t stages[LATENCY_STAGE_COUNT];
+    portMUX_TYPE lock;
+} lat = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+static inline size_t bucket_index(uint32_t us)
+{
+    if (us < LATENCY_SUB_BUCKETS) {
+        return us;
+    }
+    uint32_t octave = 31 - __builtin_clz(us);
+    if (octave > LATENCY_MAX_OCTAVE) {
+        return LATENCY_NUM_BUCKETS - 1;
+    }
+    uint32_t sub = (us >> (octave - LATENCY_SUB_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+    return (octave - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS + sub;
+}
+
+// Lower and upper (exclusive) bound of a bucket in us
+static void bucket_bounds(size_t idx, uint32_t *lo, uint32_t *hi)
+{
+    if (idx < LATENCY_SUB_BUCKETS) {
+        *lo = idx;
+        *hi = idx + 1;
+        return;
+    }
+    uint32_t shift = idx / LATENCY_SUB_BUCKETS - 1;
+    uint32_t sub = idx % LATENCY_SUB_BUCKETS;
+    *lo = (LATENCY_SUB_BUCKETS + sub) << shift;
+    *hi = (LATENCY_SUB_BUCKETS + sub + 1) << shift;
+}
+
+void latency_record(latency_stage_t stage, int64_t duration_us)
+{
+    if (stage >= LATENCY_STAGE_COUNT || duration_us < 0) {
+        return;
+    }
+    uint32_t us = duration_us > UINT32_MAX ? UINT32_MAX : (uint32_t)duration_us;
+    latency_histogram_t *h = &lat.stages[stage];
+
+    portENTER_CRITICAL(&lat.lock);
+    h->buckets[bucket_index(us)]++;
+    h->count++;
+    h->sum_us += us;
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    portEXIT_CRITICAL(&lat.lock);
+}
+
+// Value at rank (1-based) in the histogram, interpolated inside its bucket
+static uint32_t histogram_rank_us(const latency_histogram_t *h, uint32_t rank)
+{
+    uint32_t seen = 0;
+    for (size_t i = 0; i < LATENCY_NUM_BUCKETS; i++) {
+        uint32_t n = h->buckets[i];
+        if (n == 0 || seen + n < rank) {
+            seen += n;
+            continue;
+        }
+        uint32_t lo, hi;
+        bucket_bounds(i, &lo, &hi);
+        uint32_t value = lo + (uint32_t)((uint64_t)(hi - lo) * (rank - seen) / n);
+        return value < h->max_us ? value : h->max_us;
+    }
+    return h->max_us;
+}
+
+void latency_get_summary(latency_stage_t stage, latency_summary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (stage >= LATENCY_STAGE_COUNT) {
+        return;
+    }
+
+    latency_histogram_t h;
+    portENTER_CRITICAL(&lat.lock);
+    h = lat.stages[stage];
+    portEXIT_CRITICAL(&lat.lock);
+
+    if (h.count == 0) {
+        return;
+    }
+    summary->count = h.count;
+    summary->p50_us = histogram_rank_us(&h, (h.count + 1) / 2);
+    summary->p95_us = histogram_rank_us(&h, (uint32_t)(((uint64_t)h.count * 95 + 99) / 100));
+    summary->max_us = h.max_us;
+    summary->mean_us = (uint32_t)(h.sum_us / h.count);
+}
+
+const char *latency_stage_name(latency_stage_t stage)
+{
+    return stage < LATENCY_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void latency_reset(void)
+{
+    portENTER_CRITICAL(&lat.lock);
+    memset(lat.stages, 0, sizeof(lat.stages));
+    portEXIT_CRITICAL(&lat.lock);
+}
@@ -0,0 +1,269 @@
+#include "mqtt_broker.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *TAG = "MQTT_BROKER";
+
+typedef struct {
+    mqtt_broker_info_t info;
+    uint8_t consecutive_ok;     // Successful probes in a row
+} broker_t;
+
+static struct {
+    broker_t brokers[CONFIG_MQTT_MAX_BROKERS];
+    size_t count;
+    portMUX_TYPE lock;
+} pool = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+// Smoothing of RTT and PUBACK latency: new = (3 * old + sample) / 4
+static inline uint32_t ewma(uint32_t old, uint32_t sample)
+{
+    return old == 0 ? sample : (3 * old + sample) / 4;
+}
+
+esp_err_t mqtt_broker_init(const char *primary_uri)
+{
+    if (primary_uri == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    static const char *const backups[] = CONFIG_MQTT_BROKER_BACKUP_URIS;
+
+    memset(pool.brokers, 0, sizeof(pool.brokers));
+    pool.brokers[0].info.uri = primary_uri;
+    pool.count = 1;
+    for (size_t i = 0; i < sizeof(backups) / sizeof(backups[0]) && backups[i] != NULL; i++) {
+        if (pool.count == CONFIG_MQTT_MAX_BROKERS) {
+            ESP_LOGW(TAG, "Broker list full (%d), ignoring %s", CONFIG_MQTT_MAX_BROKERS, backups[i]);
+            break;
+        }
+        pool.brokers[pool.count++].info.uri = backups[i];
+    }
+
+    if (pool.count > 1) {
+        ESP_LOGI(TAG, "%u brokers, primary %s", (unsigned)pool.count, primary_uri);
+    }
+    return ESP_OK;
+}
+
+size_t mqtt_broker_count(void)
+{
+    return pool.count;
+}
+
+const char *mqtt_broker_uri(int index)
+{
+    return index >= 0 && (size_t)index < pool.count ? pool.brokers[index].info.uri : NULL;
+}
+
+// Helper: Split "scheme://host[:port][/path]" into host and port
+static bool parse_uri(const char *uri, char *host, size_t host_len, int *port)
+{
+    const char *start = strstr(uri, "://");
+    if (start == NULL) {
+        return false;
+    }
+    size_t scheme_len = (size_t)(start - uri);
+    start += 3;
+
+    size_t len = strcspn(start, ":/");
+    if (len == 0 || len >= host_len) {
+        return false;
+    }
+    memcpy(host, start, len);
+    host[len] = '\0';
+
+    if (start[len] == ':') {
+        *port = atoi(&start[len + 1]);
+    } else if (scheme_len == 5 && strncmp(uri, "mqtts", 5) == 0) {
+        *port = 8883;
+    } else if (scheme_len == 3 && strncmp(uri, "wss", 3) == 0) {
+        *port = 443;
+    } else if (scheme_len == 2 && strncmp(uri, "ws", 2) == 0) {
+        *port = 80;
+    } else {
+        *port = 1883;
+    }
+    return *port > 0;
+}
+
+// Helper: TCP connect time to the broker in ms, -1 if unreachable
+static int probe_rtt_ms(const char *uri)
+{
+    char host[64];
+    char port_str[8];
+    int port;
+    if (!parse_uri(uri, host, sizeof(host), &port)) {
+        ESP_LOGW(TAG, "Cannot parse broker URI %s", uri);
+        return -1;
+    }
+    snprintf(port_str, sizeof(port_str), "%d", port);
+
+    const struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host, port_str, &hints, &res) != 0 || res == NULL) {
+        return -1;
+    }
+
+    int rtt_ms = -1;
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        // Timed after name resolution: only the network path is compared
+        int64_t start_us = esp_timer_get_time();
+        int ret = connect(fd, res->ai_addr, res->ai_addrlen);
+        if (ret != 0 && errno == EINPROGRESS) {
+            fd_set wfds;
+            FD_ZERO(&wfds);
+            FD_SET(fd, &wfds);
+            struct timeval tv = {
+                .tv_sec = CONFIG_MQTT_BROKER_PROBE_TIMEOUT_MS / 1000,
+                .tv_usec = (CONFIG_MQTT_BROKER_PROBE_TIMEOUT_MS % 1000) * 1000,
+            };
+            int err = 0;
+            socklen_t err_len = sizeof(err);
+            if (select(fd + 1, NULL, &wfds, NULL, &tv) == 1 &&
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) == 0 && err == 0) {
+                ret = 0;
+            }
+        }
+        if (ret == 0) {
+            rtt_ms = (int)((esp_timer_get_time() - start_us) / 1000);
+            if (rtt_ms == 0) {
+                rtt_ms = 1;  // 0 means "not measured"
+            }
+        }
+        close(fd);
+    }
+    freeaddrinfo(res);
+    return rtt_ms;
+}
+
+void mqtt_broker_probe_all(void)
+{
+    for (size_t i = 0; i < pool.count; i++) {
+        int rtt_ms = probe_rtt_ms(pool.brokers[i].info.uri);
+
+        portENTER_CRITICAL(&pool.lock);
+        broker_t *b = &pool.brokers[i];
+        bool was_healthy = b->info.healthy;
+        b->info.probes++;
+        if (rtt_ms < 0) {
+            b->info.probe_failures++;
+            b->consecutive_ok = 0;
+            b->info.healthy = false;
+        } else {
+            b->info.rtt_ms = ewma(b->info.rtt_ms, (uint32_t)rtt_ms);
+            if (b->consecutive_ok < UINT8_MAX) {
+                b->consecutive_ok++;
+            }
+            b->info.healthy = b->consecutive_ok >= CONFIG_MQTT_BROKER_HEALTHY_PROBES;
+        }
+        bool healthy = b->info.healthy;
+        uint32_t smoothed_ms = b->info.rtt_ms;
+        portEXIT_CRITICAL(&pool.lock);
+
+        if (healthy != was_healthy) {
+            ESP_LOGW(TAG, "Broker %s is %s (rtt %lu ms)", pool.brokers[i].info.uri,
+                     healthy ? "healthy" : "unreachable", (unsigned long)smoothed_ms);
+        } else {
+            ESP_LOGD(TAG, "Probe %s: %d ms", pool.brokers[i].info.uri, rtt_ms);
+        }
+    }
+}
+
+void mqtt_broker_record_puback(int index, int64_t latency_us)
+{
+    if (index < 0 || (size_t)index >= pool.count || latency_us < 0) {
+        return;
+    }
+    uint32_t ms = (uint32_t)(latency_us / 1000);
+    portENTER_CRITICAL(&pool.lock);
+    pool.brokers[index].info.puback_ms = ewma(pool.brokers[index].info.puback_ms, ms > 0 ? ms : 1);
+    portEXIT_CRITICAL(&pool.lock);
+}
+
+void mqtt_broker_set_active(int index)
+{
+    portENTER_CRITICAL(&pool.lock);
+    for (size_t i = 0; i < pool.count; i++) {
+        if ((int)i != index) {
+            pool.brokers[i].info.puback_ms = 0;  // Measured again once it is in use
+        }
+    }
+    portEXIT_CRITICAL(&pool.lock);
+}
+
+// Caller holds the lock
+static bool usable_locked(size_t i)
+{
+    const mqtt_broker_info_t *b = &pool.brokers[i].info;
+    return b->puback_ms == 0 || b->puback_ms <= CONFIG_MQTT_BROKER_PUBACK_MAX_MS;
+}
+
+// Caller holds the lock; true if broker a should be preferred over broker b
+static bool better_locked(size_t a, size_t b)
+{
+    uint64_t ra = pool.brokers[a].info.rtt_ms;
+    uint64_t rb = pool.brokers[b].info.rtt_ms;
+    if (ra == 0 || rb == 0) {
+        return a < b;   // Not measured yet: list order
+    }
+    if (ra * 100 < rb * (100 - CONFIG_MQTT_BROKER_SWITCH_MARGIN_PCT)) {
+        return true;
+    }
+    return a < b && ra * 100 <= rb * (100 + CONFIG_MQTT_BROKER_SWITCH_MARGIN_PCT);
+}
+
+int mqtt_broker_select(int current, bool current_up)
+{
+    if (pool.count < 2 || current < 0 || (size_t)current >= pool.count) {
+        return current;
+    }
+
+    portENTER_CRITICAL(&pool.lock);
+    int best = current_up && usable_locked((size_t)current) ? current : -1;
+    for (size_t i = 0; i < pool.count; i++) {
+        if ((int)i == current || !pool.brokers[i].info.healthy || !usable_locked(i)) {
+            continue;
+        }
+        if (best < 0 || better_locked(i, (size_t)best)) {
+            best = (int)i;
+        }
+    }
+    portEXIT_CRITICAL(&pool.lock);
+
+    if (best < 0) {
+        // Never leave a working connection for a broker not known to be
+        // better; only an outage rotates through the list
+        best = current_up ? current : (int)(((size_t)current + 1) % pool.count);
+    }
+    return best;
+}
+
+esp_err_t mqtt_broker_get_info(int index, mqtt_broker_info_t *info)
+{
+    if (index < 0 || (size_t)index >= pool.count || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&pool.lock);
+    *info = pool.brokers[index].info;
+    portEXIT_CRITICAL(&pool.lock);
+    return ESP_OK;
+}
@@ -2,14 +2,472 @@
 #include "config.h"
 #include "mqtt_client.h"
 #include "esp_log.h"
+#include "latency_stats.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "mqtt_outbox.h"
+#include "mqtt_tls.h"
+#include "mqtt_broker.h"
 #include <string.h>
 #include <stdio.h>
 
+// MQTT 5 needs both the project switch and esp-mqtt built with CONFIG_MQTT_PROTOCOL_5
+#if CONFIG_MQTT_V5_ENABLED && defined(CONFIG_MQTT_PROTOCOL_5)
+#include "mqtt5_client.h"
+#define MQTT_MANAGER_V5 1
+#else
+#define MQTT_MANAGER_V5 0
+#endif
+
 static const char *TAG = "MQTT_MANAGER";
 
 static esp_mqtt_client_handle_t s_mqtt_client = NULL;
 static bool s_is_connected = false;
 static char s_lwt_message[256];  // Buffer for Last Will message
+static esp_mqtt_client_config_t s_mqtt_cfg;  // Kept to switch protocol version on fallback
+
+// Broker failover. An outage (or a planned switch) starts a clock; if the
+// current broker is still not connected CONFIG_MQTT_FAILOVER_TIMEOUT_MS
+// later, the next reconnect goes to another broker (see mqtt_broker_select()).
+// Written from the broker_probe job, the reconnect timer and the MQTT event
+// task: the fields and s_mqtt_cfg.broker.address.uri are under the lock.
+static struct {
+    portMUX_TYPE lock;
+    int active;                 // Index in the broker list
+    int outage_broker;          // Broker in use when the outage started
+    int64_t outage_start_us;    // Start of the outage or switch, 0 while connected
+    int64_t broker_since_us;    // Since when the current broker is being tried, 0 while connected
+    uint32_t failovers;
+    uint32_t failbacks;
+    uint32_t last_failover_ms;
+    uint32_t max_failover_ms;
+} s_failover = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+// One QoS > 0 message awaiting its PUBACK
+typedef struct {
+    int msg_id;             // -1 when free
+    int64_t time_us;        // Enqueue time, or PUBACK time if acked_early
+    bool acked_early;       // PUBACK seen before esp_mqtt_client_publish() returned the msg_id
+} inflight_entry_t;
+
+// In-flight window. The extra slots hold early PUBACKs: the broker can answer
+// before the publishing task gets its msg_id back from esp-mqtt.
+#define INFLIGHT_SLOTS (CONFIG_MQTT_INFLIGHT_WINDOW + 4)
+
+static struct {
+    inflight_entry_t entries[INFLIGHT_SLOTS];
+    mqtt_manager_stats_t stats;
+    portMUX_TYPE lock;
+} s_inflight = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+// Caller holds the lock
+static void inflight_reset_locked(void)
+{
+    for (size_t i = 0; i < INFLIGHT_SLOTS; i++) {
+        s_inflight.entries[i].msg_id = -1;
+    }
+    s_inflight.stats.inflight = 0;
+}
+
+// Caller holds the lock; returns the entry holding msg_id, or NULL
+static inflight_entry_t *inflight_find_locked(int msg_id)
+{
+    for (size_t i = 0; i < INFLIGHT_SLOTS; i++) {
+        if (s_inflight.entries[i].msg_id == msg_id) {
+            return &s_inflight.entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds the lock; forget entries esp-mqtt has given up on without telling us
+static void inflight_expire_locked(int64_t now_us)
+{
+    int64_t timeout_us = (int64_t)CONFIG_MQTT_INFLIGHT_TIMEOUT_MS * 1000;
+    for (size_t i = 0; i < INFLIGHT_SLOTS; i++) {
+        inflight_entry_t *e = &s_inflight.entries[i];
+        if (e->msg_id == -1 || now_us - e->time_us < timeout_us) {
+            continue;
+        }
+        if (!e->acked_early) {
+            s_inflight.stats.inflight--;
+            s_inflight.stats.expired++;
+        }
+        e->msg_id = -1;
+    }
+}
+
+// A QoS > 0 publish was accepted by esp-mqtt
+static void inflight_track(int msg_id, int64_t enqueued_us)
+{
+    int64_t acked_us = -1;
+
+    portENTER_CRITICAL(&s_inflight.lock);
+    inflight_entry_t *e = inflight_find_locked(msg_id);
+    if (e && e->acked_early) {
+        acked_us = e->time_us;
+        e->msg_id = -1;
+        s_inflight.stats.acked++;
+    } else if (e == NULL && (e = inflight_find_locked(-1)) != NULL) {
+        e->msg_id = msg_id;
+        e->time_us = enqueued_us;
+        e->acked_early = false;
+        s_inflight.stats.inflight++;
+        if (s_inflight.stats.inflight > s_inflight.stats.inflight_peak) {
+            s_inflight.stats.inflight_peak = s_inflight.stats.inflight;
+        }
+    }
+    portEXIT_CRITICAL(&s_inflight.lock);
+
+    if (acked_us >= 0) {
+        latency_record(LATENCY_STAGE_PUBACK, acked_us - enqueued_us);
+        mqtt_broker_record_puback(s_failover.active, acked_us - enqueued_us);
+    }
+}
+
+// MQTT_EVENT_PUBLISHED (acked) or MQTT_EVENT_DELETED (expired from the outbox)
+static void inflight_complete(int msg_id, bool acked)
+{
+    int64_t now_us = esp_timer_get_time();
+    int64_t enqueued_us = -1;
+
+    portENTER_CRITICAL(&s_inflight.lock);
+    inflight_entry_t *e = inflight_find_locked(msg_id);
+    if (e && !e->acked_early) {
+        enqueued_us = e->time_us;
+        e->msg_id = -1;
+        s_inflight.stats.inflight--;
+        if (acked) {
+            s_inflight.stats.acked++;
+        } else {
+            s_inflight.stats.expired++;
+        }
+    } else if (e == NULL && acked && (e = inflight_find_locked(-1)) != NULL) {
+        e->msg_id = msg_id;
+        e->time_us = now_us;
+        e->acked_early = true;
+    }
+    portEXIT_CRITICAL(&s_inflight.lock);
+
+    if (acked && enqueued_us >= 0) {
+        latency_record(LATENCY_STAGE_PUBACK, now_us - enqueued_us);
+        mqtt_broker_record_puback(s_failover.active, now_us - enqueued_us);
+    }
+}
+
+// Reconnect backoff. esp-mqtt's own reconnect uses a fixed delay, so a broker
+// restart makes every node come back in lockstep; instead each attempt waits a
+// random delay up to an exponentially growing ceiling ("full jitter").
+static struct {
+    esp_timer_handle_t timer;
+    uint32_t attempt;           // Failed attempts since the last connection
+    int64_t down_since_us;      // When the connection was lost, 0 while connected
+    uint32_t reconnects;
+    uint32_t attempts;
+    uint32_t last_reconnect_ms;
+    uint32_t max_reconnect_ms;
+    uint32_t sessions_resumed;
+} s_reconnect;
+
+#if MQTT_MANAGER_V5
+// Hot topics published with MQTT 5 properties. Aliases are per connection:
+// the first publish on a topic carries both the topic and its alias, later
+// QoS 0 publishes only the alias. QoS > 0 publishes always keep the topic
+// because esp-mqtt resends stored packets verbatim after a reconnect, when
+// the broker no longer knows the alias.
+typedef struct {
+    const char *topic;
+    uint16_t alias;             // 1 .. number of hot topics
+    uint32_t expiry_s;          // Message expiry interval, 0 for none
+    uint32_t announced_on;      // s_v5.connection the alias mapping was sent on
+} hot_topic_t;
+
+static struct {
+    bool active;                            // Connecting with MQTT 5 (false after falling back to 3.1.1)
+    bool aliases;                           // Topic aliases usable on this connection
+    volatile uint32_t connection;           // Bumped on every connect and disconnect
+    mqtt5_user_property_handle_t schema;    // "schema" user property sent with every publish
+    char schema_version[8];
+    hot_topic_t topics[3];
+} s_v5 = {
+    .connection = 1,
+    .topics = {
+        { CONFIG_MQTT_TOPIC,      1, CONFIG_MQTT_TELEMETRY_EXPIRY_S, 0 },
+        { CONFIG_MQTT_CBOR_TOPIC, 2, CONFIG_MQTT_TELEMETRY_EXPIRY_S, 0 },
+        { CONFIG_MQTT_DIAG_TOPIC, 3, 2 * CONFIG_DIAG_INTERVAL / 1000, 0 },
+    },
+};
+
+static hot_topic_t *hot_topic_find(const char *topic)
+{
+    for (size_t i = 0; i < sizeof(s_v5.topics) / sizeof(s_v5.topics[0]); i++) {
+        if (strcmp(s_v5.topics[i].topic, topic) == 0) {
+            return &s_v5.topics[i];
+        }
+    }
+    return NULL;
+}
+
+// Helper: Go back to MQTT 3.1.1 for the following connection attempts
+static void v5_fallback(const char *reason)
+{
+    if (!s_v5.active) {
+        return;
+    }
+    ESP_LOGW(TAG, "Broker refused MQTT 5 (%s), falling back to MQTT 3.1.1", reason);
+    s_v5.active = false;
+    portENTER_CRITICAL(&s_failover.lock);
+    s_mqtt_cfg.session.protocol_ver = MQTT_PROTOCOL_V_3_1_1;
+    esp_mqtt_client_config_t cfg = s_mqtt_cfg;  // URI may change under a broker switch
+    portEXIT_CRITICAL(&s_failover.lock);
+    esp_err_t err = esp_mqtt_set_config(s_mqtt_client, &cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to switch protocol version: %s", esp_err_to_name(err));
+    }
+}
+#endif
+
+// Hand a message to esp-mqtt, with MQTT 5 properties when connected with v5.
+// Caller holds s_outbox_lock: properties apply to the next publish call only.
+static int client_publish(const char *topic, const void *data, size_t len, int qos, int retain)
+{
+#if MQTT_MANAGER_V5
+    if (s_v5.active) {
+        esp_mqtt5_publish_property_config_t property = {
+            .user_property = s_v5.schema,
+        };
+        // A mapping counts only on the connection it was sent on: the event
+        // handler cannot take s_outbox_lock, so it bumps the connection
+        // number instead of clearing the flags under us
+        uint32_t connection = s_v5.connection;
+        const char *wire_topic = topic;
+        hot_topic_t *hot = hot_topic_find(topic);
+        if (hot) {
+            // Stale telemetry is dropped by the broker instead of delivered late
+            property.message_expiry_interval = hot->expiry_s;
+            if (s_v5.aliases) {
+                property.topic_alias = hot->alias;
+                if (hot->announced_on == connection && qos == 0) {
+                    wire_topic = "";
+                }
+            }
+        }
+
+        esp_err_t err = esp_mqtt5_client_set_publish_property(s_mqtt_client, &property);
+        if (err != ESP_OK && property.topic_alias != 0) {
+            // esp-mqtt checks the alias against the broker's Topic Alias
+            // Maximum when the properties are set: send with the full topic
+            ESP_LOGW(TAG, "Topic alias %u refused, disabling aliases for this connection", property.topic_alias);
+            s_v5.aliases = false;
+            property.topic_alias = 0;
+            wire_topic = topic;
+            err = esp_mqtt5_client_set_publish_property(s_mqtt_client, &property);
+        }
+        if (err != ESP_OK) {
+            // Publishing now would reuse the properties of the previous message
+            ESP_LOGE(TAG, "Failed to set publish properties: %s", esp_err_to_name(err));
+            return -1;
+        }
+
+        int msg_id = esp_mqtt_client_publish(s_mqtt_client, wire_topic, (const char *)data, (int)len, qos, retain);
+        if (msg_id >= 0 && property.topic_alias != 0) {
+            hot->announced_on = connection;
+        }
+        return msg_id;
+    }
+#endif
+    return esp_mqtt_client_publish(s_mqtt_client, topic, (const char *)data, (int)len, qos, retain);
+}
+
+// Serializes the outbox and the publishes draining it. Only taken from
+// publishing tasks, never from the MQTT event handler: esp-mqtt may hold its
+// own client lock while dispatching events.
+static SemaphoreHandle_t s_outbox_lock = NULL;
+
+static bool inflight_has_room(void)
+{
+    portENTER_CRITICAL(&s_inflight.lock);
+    inflight_expire_locked(esp_timer_get_time());
+    bool room = s_inflight.stats.inflight < CONFIG_MQTT_INFLIGHT_WINDOW;
+    portEXIT_CRITICAL(&s_inflight.lock);
+    return room;
+}
+
+// Hand a QoS > 0 message to esp-mqtt and track it until its PUBACK.
+// Returns the msg_id, -1 on error, -2 if the esp-mqtt outbox is at its limit.
+static int send_tracked(const char *topic, const void *data, size_t len, int qos, int retain)
+{
+    int64_t enqueued_us = esp_timer_get_time();
+    int msg_id = client_publish(topic, data, len, qos, retain);
+    if (msg_id >= 0) {
+        ESP_LOGI(TAG, "Message published to topic '%s', msg_id=%d", topic, msg_id);
+        inflight_track(msg_id, enqueued_us);
+    }
+    return msg_id;
+}
+
+// Caller holds s_outbox_lock; sends queued messages while the window has room
+static void outbox_drain_locked(void)
+{
+    mqtt_outbox_msg_t msg;
+    while (s_is_connected && inflight_has_room() && mqtt_outbox_peek(&msg)) {
+        if (send_tracked(msg.topic, msg.data, msg.len, msg.qos, msg.retain) < 0) {
+            break;  // Retry on the next publish
+        }
+        mqtt_outbox_pop();
+    }
+}
+
+// Caller holds s_failover.lock: make index the active broker
+static void broker_switch_locked(int index, int64_t now_us)
+{
+    if (index < s_failover.active) {
+        s_failover.failbacks++;
+    } else {
+        s_failover.failovers++;
+    }
+    s_failover.active = index;
+    s_failover.broker_since_us = now_us;
+    s_mqtt_cfg.broker.address.uri = mqtt_broker_uri(index);
+}
+
+// Helper: Point the client at the broker chosen by broker_switch_locked();
+// takes effect on the next connect
+static void broker_switch_apply(int from, int index, const char *reason)
+{
+    const char *uri = mqtt_broker_uri(index);
+    ESP_LOGW(TAG, "Switching broker %s -> %s (%s)", mqtt_broker_uri(from), uri, reason);
+
+    mqtt_broker_set_active(index);
+    esp_err_t err = esp_mqtt_client_set_uri(s_mqtt_client, uri);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set broker URI: %s", esp_err_to_name(err));
+    }
+    s_reconnect.attempt = 0;    // Fresh backoff for the new broker
+}
+
+// esp_timer callback: the backoff delay has passed
+static void reconnect_timer_cb(void *arg)
+{
+    if (s_mqtt_client == NULL || s_is_connected) {
+        return;
+    }
+
+    // The current broker had its chance: move on to the best other one
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_failover.lock);
+    int current = s_failover.active;
+    bool expired = s_failover.broker_since_us != 0 &&
+                   now_us - s_failover.broker_since_us >= (int64_t)CONFIG_MQTT_FAILOVER_TIMEOUT_MS * 1000;
+    portEXIT_CRITICAL(&s_failover.lock);
+
+    if (mqtt_broker_count() > 1 && expired) {
+        int next = mqtt_broker_select(current, false);
+        bool switched = false;
+        portENTER_CRITICAL(&s_failover.lock);
+        if (s_failover.active == current) {
+            if (next != current) {
+                broker_switch_locked(next, now_us);
+                switched = true;
+            } else {
+                s_failover.broker_since_us = now_us;
+            }
+        }
+        portEXIT_CRITICAL(&s_failover.lock);
+        if (switched) {
+            broker_switch_apply(current, next, "unreachable");
+        }
+    }
+
+    s_reconnect.attempts++;
+    esp_err_t err = esp_mqtt_client_reconnect(s_mqtt_client);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Reconnect attempt failed to start: %s", esp_err_to_name(err));
+    }
+}
+
+// Helper: Arm the reconnect timer for the next attempt
+static void reconnect_schedule(void)
+{
+    uint32_t ceiling = CONFIG_MQTT_RECONNECT_MAX_MS;
+    if (s_reconnect.attempt < 16 &&
+        ((uint32_t)CONFIG_MQTT_RECONNECT_BASE_MS << s_reconnect.attempt) < ceiling) {
+        ceiling = (uint32_t)CONFIG_MQTT_RECONNECT_BASE_MS << s_reconnect.attempt;
+    }
+    uint32_t delay_ms = esp_random() % (ceiling + 1);
+    s_reconnect.attempt++;
+
+    // Never back off past the failover deadline, which bounds the failover time
+    portENTER_CRITICAL(&s_failover.lock);
+    int64_t since_us = s_failover.broker_since_us;
+    portEXIT_CRITICAL(&s_failover.lock);
+    if (mqtt_broker_count() > 1 && since_us != 0) {
+        int64_t left_ms = (since_us + (int64_t)CONFIG_MQTT_FAILOVER_TIMEOUT_MS * 1000 -
+                           esp_timer_get_time()) / 1000;
+        if (left_ms < 0) {
+            left_ms = 0;
+        }
+        if (delay_ms > left_ms) {
+            delay_ms = (uint32_t)left_ms;
+        }
+    }
+
+    esp_timer_stop(s_reconnect.timer);  // Not running is fine
+    esp_err_t err = esp_timer_start_once(s_reconnect.timer, (uint64_t)delay_ms * 1000);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to arm reconnect timer: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI(TAG, "Reconnecting in %lu ms (attempt %lu, ceiling %lu ms)",
+             (unsigned long)delay_ms, (unsigned long)s_reconnect.attempt, (unsigned long)ceiling);
+}
+
+// Helper: Connected, which ends an outage or switch; measures the failover time
+static void failover_connected(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    int64_t failover_ms = -1;
+
+    portENTER_CRITICAL(&s_failover.lock);
+    int active = s_failover.active;
+    int left = s_failover.outage_broker;
+    if (s_failover.outage_start_us != 0) {
+        if (active != left) {
+            failover_ms = (now_us - s_failover.outage_start_us) / 1000;
+            s_failover.last_failover_ms = (uint32_t)failover_ms;
+            if ((uint32_t)failover_ms > s_failover.max_failover_ms) {
+                s_failover.max_failover_ms = (uint32_t)failover_ms;
+            }
+        }
+        s_failover.outage_start_us = 0;
+        s_failover.broker_since_us = 0;
+    }
+    portEXIT_CRITICAL(&s_failover.lock);
+
+    if (failover_ms >= 0) {
+        ESP_LOGW(TAG, "Now on broker %s, %lu ms after leaving %s", mqtt_broker_uri(active),
+                 (unsigned long)failover_ms, mqtt_broker_uri(left));
+    }
+}
+
+// Helper: Disconnected (or a connect attempt failed); starts the outage clock
+static void failover_disconnected(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_failover.lock);
+    if (s_failover.outage_start_us == 0) {
+        s_failover.outage_start_us = now_us;
+        s_failover.broker_since_us = now_us;
+        s_failover.outage_broker = s_failover.active;
+    }
+    portEXIT_CRITICAL(&s_failover.lock);
+}
 
 // MQTT event handler
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
@@ -18,13 +476,44 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED:
-        ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED");
+        ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED, session_present=%d", event->session_present);
+#if MQTT_MANAGER_V5
+        // Topic alias mappings start empty on every connection
+        s_v5.connection++;
+        s_v5.aliases = true;
+#endif
         s_is_connected = true;
+        s_reconnect.attempt = 0;
+        failover_connected();
+        if (event->session_present) {
+            s_reconnect.sessions_resumed++;
+        }
+        if (s_reconnect.down_since_us != 0) {
+            uint32_t down_ms = (uint32_t)((esp_timer_get_time() - s_reconnect.down_since_us) / 1000);
+            s_reconnect.down_since_us = 0;
+            s_reconnect.reconnects++;
+            s_reconnect.last_reconnect_ms = down_ms;
+            if (down_ms > s_reconnect.max_reconnect_ms) {
+                s_reconnect.max_reconnect_ms = down_ms;
+            }
+            ESP_LOGI(TAG, "Reconnected after %lu ms", (unsigned long)down_ms);
+        }
         break;
         
     case MQTT_EVENT_DISCONNECTED:
+        // Also dispatched when a connection attempt fails
         ESP_LOGI(TAG, "MQTT_EVENT_DISCONNECTED");
+#if MQTT_MANAGER_V5
+        // The mappings died with the connection; nothing may go out alias-only
+        s_v5.aliases = false;
+        s_v5.connection++;
+#endif
+        if (s_is_connected) {
+            s_reconnect.down_since_us = esp_timer_get_time();
+        }
+        failover_disconnected();
         s_is_connected = false;
+        reconnect_schedule();
         break;
         
     case MQTT_EVENT_SUBSCRIBED:
@@ -37,6 +526,13 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         
     case MQTT_EVENT_PUBLISHED:
         ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
+        inflight_complete(event->msg_id, true);
+        break;
+
+    case MQTT_EVENT_DELETED:
+        // esp-mqtt dropped the message from its outbox before it was acknowledged
+        ESP_LOGW(TAG, "MQTT_EVENT_DELETED, msg_id=%d", event->msg_id);
+        inflight_complete(event->msg_id, false);
         break;
         
     case MQTT_EVENT_DATA:
@@ -50,6 +546,15 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         if (event->error_handle->error_type == MQTT_ERROR_TYPE_TCP_TRANSPORT) {
             ESP_LOGE(TAG, "Transport error reported, errno=%d", event->error_handle->esp_transport_sock_errno);
         }
+#if MQTT_MANAGER_V5
+        // A 3.1.1-only broker answers a v5 CONNECT with "unacceptable protocol version"
+        // (1), a v5 broker configured without it with "unsupported protocol version" (0x84)
+        if (event->error_handle->error_type == MQTT_ERROR_TYPE_CONNECTION_REFUSED &&
+            (event->error_handle->connect_return_code == MQTT_CONNECTION_REFUSE_PROTOCOL ||
+             (int)event->error_handle->connect_return_code == 0x84)) {
+            v5_fallback("protocol version refused");
+        }
+#endif
         break;
         
     default:
@@ -80,8 +585,47 @@ esp_err_t mqtt_manager_init(const char *broker_uri, const char *client_id, const
 
     ESP_LOGI(TAG, "Last Will configured: %s", s_lwt_message);
 
+    portENTER_CRITICAL(&s_inflight.lock);
+    inflight_reset_locked();
+    portEXIT_CRITICAL(&s_inflight.lock);
+
+    if (s_outbox_lock == NULL) {
+        s_outbox_lock = xSemaphoreCreateMutex();
+        if (s_outbox_lock == NULL) {
+            ESP_LOGE(TAG, "Failed to create outbox mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    mqtt_outbox_init((mqtt_outbox_policy_t)CONFIG_MQTT_OUTBOX_POLICY);
+
+    if (s_reconnect.timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = reconnect_timer_cb,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "mqtt_reconnect",
+        };
+        esp_err_t err = esp_timer_create(&timer_args, &s_reconnect.timer);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create reconnect timer: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+    s_reconnect.attempt = 0;
+    s_reconnect.down_since_us = 0;
+
+    // Broker list: broker_uri first, then the configured backups
+    esp_err_t broker_err = mqtt_broker_init(broker_uri);
+    if (broker_err != ESP_OK) {
+        return broker_err;
+    }
+    s_failover.active = 0;
+    s_failover.outage_broker = 0;
+    s_failover.outage_start_us = esp_timer_get_time();  // Until the first CONNECTED
+    s_failover.broker_since_us = s_failover.outage_start_us;
+
     // MQTT client configuration with Last Will Testament
-    esp_mqtt_client_config_t mqtt_cfg = {
+    s_mqtt_cfg = (esp_mqtt_client_config_t){
         .broker.address.uri = broker_uri,
         .credentials.client_id = client_id,
         .session.last_will = {
@@ -92,9 +636,27 @@ esp_err_t mqtt_manager_init(const char *broker_uri, const char *client_id, const
             .retain = true,
         },
         .session.keepalive = CONFIG_MQTT_KEEPALIVE,
+        // Persistent session: the broker keeps subscriptions and unacknowledged QoS 1
+        // messages across a reconnect (needs a stable client ID)
+        .session.disable_clean_session = CONFIG_MQTT_PERSISTENT_SESSION,
+        // Reconnects are driven by reconnect_schedule() with jittered backoff
+        .network.disable_auto_reconnect = true,
+        // Hard cap on the esp-mqtt outbox (heap); the in-flight window normally keeps it far below
+        .outbox.limit = CONFIG_MQTT_OUTBOX_MAX_BYTES,
+#if MQTT_MANAGER_V5
+        .session.protocol_ver = MQTT_PROTOCOL_V_5,
+#endif
     };
 
-    s_mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
+#if CONFIG_MQTT_TLS_ENABLED
+    // Own TLS transport so the session survives reconnects (esp-mqtt destroys it with the client)
+    s_mqtt_cfg.network.transport = mqtt_tls_transport_create();
+    if (s_mqtt_cfg.network.transport == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+
+    s_mqtt_client = esp_mqtt_client_init(&s_mqtt_cfg);
     if (s_mqtt_client == NULL) {
         ESP_LOGE(TAG, "Failed to initialize MQTT client");
         return ESP_FAIL;
@@ -110,6 +672,30 @@ esp_err_t mqtt_manager_init(const char *broker_uri, const char *client_id, const
         return err;
     }
 
+#if MQTT_MANAGER_V5
+    s_v5.active = true;
+
+    // In MQTT 5 a session outlives the connection only for its expiry interval
+    esp_mqtt5_connection_property_config_t connect_property = {
+        .session_expiry_interval = CONFIG_MQTT_PERSISTENT_SESSION ? CONFIG_MQTT_SESSION_EXPIRY_S : 0,
+    };
+    err = esp_mqtt5_client_set_connect_property(s_mqtt_client, &connect_property);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set MQTT 5 connect properties: %s", esp_err_to_name(err));
+    }
+
+    if (s_v5.schema == NULL) {
+        snprintf(s_v5.schema_version, sizeof(s_v5.schema_version), "%d", CONFIG_TELEMETRY_SCHEMA_VERSION);
+        esp_mqtt5_user_property_item_t schema = { "schema", s_v5.schema_version };
+        err = esp_mqtt5_client_set_user_property(&s_v5.schema, &schema, 1);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to create schema user property: %s", esp_err_to_name(err));
+            s_v5.schema = NULL;
+        }
+    }
+    ESP_LOGI(TAG, "Using MQTT 5 (topic aliases, message expiry, schema %s)", s_v5.schema_version);
+#endif
+
     // Start MQTT client
     err = esp_mqtt_client_start(s_mqtt_client);
     if (err != ESP_OK) {
@@ -130,6 +716,8 @@ esp_err_t mqtt_manager_deinit(void)
         return ESP_ERR_INVALID_STATE;
     }
 
+    esp_timer_stop(s_reconnect.timer);
+
     esp_err_t err = esp_mqtt_client_stop(s_mqtt_client);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to stop MQTT client: %s", esp_err_to_name(err));
@@ -144,34 +732,153 @@ esp_err_t mqtt_manager_deinit(void)
     s_mqtt_client = NULL;
     s_is_connected = false;
 
+#if MQTT_MANAGER_V5
+    if (s_v5.schema != NULL) {
+        esp_mqtt5_client_delete_user_property(s_v5.schema);
+        s_v5.schema = NULL;
+    }
+    s_v5.active = false;
+#endif
+
     ESP_LOGI(TAG, "MQTT client deinitialized");
     return ESP_OK;
 }
 
 int mqtt_manager_publish(const char *topic, const char *message, int qos, int retain)
+{
+    if (message == NULL) {
+        ESP_LOGE(TAG, "Topic or message is NULL");
+        return -1;
+    }
+
+    return mqtt_manager_publish_bin(topic, message, strlen(message), qos, retain);
+}
+
+// Helper: Publish, or queue in the outbox if may_queue; -2 if it would have been queued
+static int publish_bin(const char *topic, const void *data, size_t len, int qos, int retain, bool may_queue)
 {
     if (s_mqtt_client == NULL) {
         ESP_LOGE(TAG, "MQTT client not initialized");
         return -1;
     }
 
-    if (topic == NULL || message == NULL) {
+    if (topic == NULL || data == NULL) {
         ESP_LOGE(TAG, "Topic or message is NULL");
         return -1;
     }
 
-    int msg_id = esp_mqtt_client_publish(s_mqtt_client, topic, message, 
-                                          strlen(message), qos, retain);
+    // QoS 0 is fire-and-forget: never stored, so it skips the outbox
+    // (the lock only keeps MQTT 5 publish properties paired with their publish)
+    if (qos == 0) {
+        xSemaphoreTake(s_outbox_lock, portMAX_DELAY);
+        int msg_id = client_publish(topic, data, len, 0, retain);
+        xSemaphoreGive(s_outbox_lock);
+        if (msg_id < 0) {
+            ESP_LOGE(TAG, "Failed to publish message to topic: %s", topic);
+            return -1;
+        }
+        ESP_LOGI(TAG, "Message published to topic '%s', msg_id=%d", topic, msg_id);
+        return msg_id;
+    }
+
+    xSemaphoreTake(s_outbox_lock, portMAX_DELAY);
     
-    if (msg_id == -1) {
+    // Older queued messages go first to keep the order
+    outbox_drain_locked();
+
+    mqtt_outbox_stats_t queued;
+    mqtt_outbox_get_stats(&queued);
+
+    int msg_id = -2;
+    if (s_is_connected && queued.count == 0 && inflight_has_room()) {
+        msg_id = send_tracked(topic, data, len, qos, retain);
+    }
+
+    // Disconnected, window full or esp-mqtt outbox full: wait in the budgeted outbox
+    if (msg_id == -2 && !may_queue) {
+        ESP_LOGD(TAG, "Message to topic '%s' not handed on, caller keeps it", topic);
+    } else if (msg_id == -2) {
+        esp_err_t err = mqtt_outbox_push(topic, data, len, qos, retain);
+        if (err == ESP_OK) {
+            ESP_LOGD(TAG, "Message to topic '%s' queued in the outbox", topic);
+            msg_id = 0;
+        } else {
+            portENTER_CRITICAL(&s_inflight.lock);
+            s_inflight.stats.rejected++;
+            portEXIT_CRITICAL(&s_inflight.lock);
+            ESP_LOGW(TAG, "Outbox full, not publishing to topic: %s", topic);
+            msg_id = -1;
+        }
+    } else if (msg_id == -1) {
         ESP_LOGE(TAG, "Failed to publish message to topic: %s", topic);
-    } else {
-        ESP_LOGI(TAG, "Message published to topic '%s', msg_id=%d", topic, msg_id);
     }
 
+    xSemaphoreGive(s_outbox_lock);
     return msg_id;
 }
 
+int mqtt_manager_publish_bin(const char *topic, const void *data, size_t len, int qos, int retain)
+{
+    return publish_bin(topic, data, len, qos, retain, true);
+}
+
+int mqtt_manager_publish_bin_now(const char *topic, const void *data, size_t len, int qos, int retain)
+{
+    return publish_bin(topic, data, len, qos, retain, false);
+}
+
+void mqtt_manager_check_brokers(void)
+{
+    if (s_mqtt_client == NULL || mqtt_broker_count() < 2) {
+        return;
+    }
+
+    mqtt_broker_probe_all();
+
+    // Outages are handled by the reconnect timer; here only switch a working connection
+    portENTER_CRITICAL(&s_failover.lock);
+    bool outage = s_failover.outage_start_us != 0;
+    int current = s_failover.active;
+    portEXIT_CRITICAL(&s_failover.lock);
+    if (!s_is_connected || outage) {
+        return;
+    }
+    int best = mqtt_broker_select(current, true);
+    if (best == current) {
+        return;
+    }
+
+    // Recheck: the connection may have dropped while the probes ran
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_failover.lock);
+    bool switched = s_failover.outage_start_us == 0 && s_failover.active == current;
+    if (switched) {
+        s_failover.outage_start_us = now_us;
+        s_failover.outage_broker = current;
+        broker_switch_locked(best, now_us);
+    }
+    portEXIT_CRITICAL(&s_failover.lock);
+    if (!switched) {
+        return;
+    }
+
+    broker_switch_apply(current, best, best < current ? "fail-back" : "faster or healthier");
+    esp_err_t err = esp_mqtt_client_disconnect(s_mqtt_client);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to disconnect for broker switch: %s", esp_err_to_name(err));
+    }
+}
+
+void mqtt_manager_process_outbox(void)
+{
+    if (s_outbox_lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_outbox_lock, portMAX_DELAY);
+    outbox_drain_locked();
+    xSemaphoreGive(s_outbox_lock);
+}
+
 int mqtt_manager_subscribe(const char *topic, int qos)
 {
     if (s_mqtt_client == NULL) {
@@ -222,3 +929,68 @@ bool mqtt_manager_is_connected(void)
 {
     return s_is_connected;
 }
+
+uint32_t mqtt_manager_get_pressure(void)
+{
+    portENTER_CRITICAL(&s_inflight.lock);
+    inflight_expire_locked(esp_timer_get_time());
+    uint32_t inflight = s_inflight.stats.inflight;
+    portEXIT_CRITICAL(&s_inflight.lock);
+
+    // A full window only means new messages start queueing: it counts as the high mark,
+    // the outbox filling up takes the pressure on to 100
+    uint32_t pressure = inflight * CONFIG_MQTT_BACKPRESSURE_HIGH_PCT / CONFIG_MQTT_INFLIGHT_WINDOW;
+    if (s_outbox_lock != NULL) {
+        mqtt_outbox_stats_t queued;
+        xSemaphoreTake(s_outbox_lock, portMAX_DELAY);
+        mqtt_outbox_get_stats(&queued);
+        xSemaphoreGive(s_outbox_lock);
+        uint32_t queued_pressure = queued.bytes * 100 / CONFIG_MQTT_OUTBOX_BUDGET;
+        if (queued_pressure > pressure) {
+            pressure = queued_pressure;
+        }
+    }
+    if (s_mqtt_client != NULL) {
+        int outbox = esp_mqtt_client_get_outbox_size(s_mqtt_client);
+        uint32_t outbox_pressure = outbox > 0 ? (uint32_t)outbox * 100 / CONFIG_MQTT_OUTBOX_MAX_BYTES : 0;
+        if (outbox_pressure > pressure) {
+            pressure = outbox_pressure;
+        }
+    }
+    return pressure;
+}
+
+void mqtt_manager_get_stats(mqtt_manager_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_inflight.lock);
+    *stats = s_inflight.stats;
+    portEXIT_CRITICAL(&s_inflight.lock);
+#if MQTT_MANAGER_V5
+    stats->protocol_v5 = s_v5.active;
+#else
+    stats->protocol_v5 = false;
+#endif
+    portENTER_CRITICAL(&s_failover.lock);
+    stats->active_broker = s_failover.active;
+    stats->failovers = s_failover.failovers;
+    stats->failbacks = s_failover.failbacks;
+    stats->last_failover_ms = s_failover.last_failover_ms;
+    stats->max_failover_ms = s_failover.max_failover_ms;
+    portEXIT_CRITICAL(&s_failover.lock);
+    stats->reconnects = s_reconnect.reconnects;
+    stats->reconnect_attempts = s_reconnect.attempts;
+    stats->last_reconnect_ms = s_reconnect.last_reconnect_ms;
+    stats->max_reconnect_ms = s_reconnect.max_reconnect_ms;
+    stats->sessions_resumed = s_reconnect.sessions_resumed;
+    stats->outbox_bytes = s_mqtt_client ? esp_mqtt_client_get_outbox_size(s_mqtt_client) : 0;
+    if (s_outbox_lock != NULL) {
+        xSemaphoreTake(s_outbox_lock, portMAX_DELAY);
+        mqtt_outbox_get_stats(&stats->queue);
+        xSemaphoreGive(s_outbox_lock);
+    } else {
+        memset(&stats->queue, 0, sizeof(stats->queue));
+    }
+}
@@ -0,0 +1,137 @@
+#include "mqtt_outbox.h"
+#include "config.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "MQTT_OUTBOX";
+
+// Record layout in the arena: header, NUL-terminated topic, payload, padded
+// to 4 bytes so the next header stays aligned
+typedef struct {
+    uint32_t size;          // Whole record, padding included
+    uint32_t len;           // Payload length
+    uint16_t topic_len;     // Topic length including the NUL
+    uint8_t qos;
+    uint8_t retain;
+} outbox_record_t;
+
+#define OUTBOX_ALIGN(n) (((n) + 3u) & ~3u)
+
+static struct {
+    uint8_t arena[CONFIG_MQTT_OUTBOX_BUDGET] __attribute__((aligned(4)));
+    mqtt_outbox_policy_t policy;
+    mqtt_outbox_stats_t stats;
+} outbox;
+
+static inline outbox_record_t *record_at(uint32_t offset)
+{
+    return (outbox_record_t *)&outbox.arena[offset];
+}
+
+static inline const char *record_topic(const outbox_record_t *r)
+{
+    return (const char *)(r + 1);
+}
+
+// Helper: Remove the record at offset, closing the gap
+static void remove_at(uint32_t offset)
+{
+    uint32_t size = record_at(offset)->size;
+    memmove(&outbox.arena[offset], &outbox.arena[offset + size], outbox.stats.bytes - offset - size);
+    outbox.stats.bytes -= size;
+    outbox.stats.count--;
+}
+
+// Helper: Offset of the oldest record on topic, -1 if there is none
+static int32_t find_topic(const char *topic)
+{
+    for (uint32_t off = 0; off < outbox.stats.bytes; off += record_at(off)->size) {
+        if (strcmp(record_topic(record_at(off)), topic) == 0) {
+            return (int32_t)off;
+        }
+    }
+    return -1;
+}
+
+void mqtt_outbox_init(mqtt_outbox_policy_t policy)
+{
+    memset(&outbox.stats, 0, sizeof(outbox.stats));
+    outbox.policy = policy;
+}
+
+esp_err_t mqtt_outbox_push(const char *topic, const void *data, size_t len, int qos, int retain)
+{
+    size_t topic_len = strlen(topic) + 1;
+    size_t size = OUTBOX_ALIGN(sizeof(outbox_record_t) + topic_len + len);
+    if (size > CONFIG_MQTT_OUTBOX_BUDGET || topic_len > UINT16_MAX) {
+        ESP_LOGW(TAG, "Message of %u bytes exceeds the outbox budget, dropped", (unsigned)len);
+        outbox.stats.dropped++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Make room according to the policy
+    while (outbox.stats.bytes + size > CONFIG_MQTT_OUTBOX_BUDGET) {
+        if (outbox.policy == MQTT_OUTBOX_DROP_NEWEST) {
+            outbox.stats.dropped++;
+            ESP_LOGD(TAG, "Outbox full, refused message on %s", topic);
+            return ESP_ERR_NO_MEM;
+        }
+
+        int32_t victim = outbox.policy == MQTT_OUTBOX_COALESCE ? find_topic(topic) : -1;
+        if (victim >= 0) {
+            outbox.stats.coalesced++;
+        } else {
+            victim = 0;
+            outbox.stats.dropped++;
+        }
+        ESP_LOGD(TAG, "Outbox full, evicting message on %s", record_topic(record_at((uint32_t)victim)));
+        remove_at((uint32_t)victim);
+    }
+
+    outbox_record_t *r = record_at(outbox.stats.bytes);
+    r->size = (uint32_t)size;
+    r->len = (uint32_t)len;
+    r->topic_len = (uint16_t)topic_len;
+    r->qos = (uint8_t)qos;
+    r->retain = (uint8_t)retain;
+    memcpy((char *)(r + 1), topic, topic_len);
+    memcpy((char *)(r + 1) + topic_len, data, len);
+
+    outbox.stats.bytes += (uint32_t)size;
+    outbox.stats.count++;
+    outbox.stats.queued++;
+    if (outbox.stats.bytes > outbox.stats.peak_bytes) {
+        outbox.stats.peak_bytes = outbox.stats.bytes;
+    }
+    return ESP_OK;
+}
+
+bool mqtt_outbox_peek(mqtt_outbox_msg_t *msg)
+{
+    if (outbox.stats.count == 0) {
+        return false;
+    }
+    const outbox_record_t *r = record_at(0);
+    msg->topic = record_topic(r);
+    msg->data = record_topic(r) + r->topic_len;
+    msg->len = r->len;
+    msg->qos = r->qos;
+    msg->retain = r->retain;
+    return true;
+}
+
+void mqtt_outbox_pop(void)
+{
+    if (outbox.stats.count == 0) {
+        return;
+    }
+    remove_at(0);
+    outbox.stats.sent++;
+}
+
+void mqtt_outbox_get_stats(mqtt_outbox_stats_t *stats)
+{
+    if (stats) {
+        *stats = outbox.stats;
+    }
+}
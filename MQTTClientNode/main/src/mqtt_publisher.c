@@ -2,20 +2,53 @@
 #include "config.h"
 #include "esp_log.h"
 #include "esp_netif.h"
-#include "dht11_manager.h"
-#include "hygrometer_manager.h"
+#include "sensor_sampler.h"
 #include "mqtt_manager.h"
 #include "led_manager.h"
-#include "cJSON.h"
-#include <time.h>
+#include "telemetry.h"
+#include "offline_store.h"
+#include "latency_stats.h"
+#include "esp_timer.h"
+#include <sys/time.h>
 #include <string.h>
-#include "freertos/FreeRTOS.h"
 
 static const char *TAG = "MQTT_PUBLISHER";
 
-// State tracking for sensor read intervals
-static uint32_t last_dht11_read = 0;
-static uint32_t last_hygro_read = 0;
+// Payload buffer, reused by every publish (publishing runs from a single task)
+static char payload_buf[CONFIG_MQTT_PAYLOAD_MAX];
+
+// Active payload format, CONFIG_MQTT_PAYLOAD_FORMAT until changed at runtime
+static mqtt_payload_format_t payload_format = CONFIG_MQTT_PAYLOAD_FORMAT;
+
+// Samples waiting to be published, oldest first
+static struct {
+    telemetry_sample_t samples[CONFIG_MQTT_BATCH_SIZE];
+    int64_t taken_us[CONFIG_MQTT_BATCH_SIZE];   // esp_timer time each sample was taken
+    size_t count;
+} batch = {
+    .count = 0
+};
+
+// Change-driven publishing: last sample let through and when
+static struct {
+    telemetry_sample_t last_sent;
+    int64_t last_sent_us;
+    bool have_last;
+} deadband = {
+    .have_last = false
+};
+
+// Backpressure: while the MQTT in-flight window or outbox fills up, only every
+// stretch-th cycle flushes; the cycles in between coalesce samples in the batch
+static struct {
+    uint32_t stretch;       // Publish interval multiplier, 1 .. CONFIG_MQTT_BACKPRESSURE_MAX_STRETCH
+    uint32_t cycle;         // Cycles since the last flush slot
+} backoff = {
+    .stretch = 1,
+    .cycle = 0
+};
+
+static mqtt_publisher_stats_t stats;
 
 // Helper: Get local IP address
 static bool get_local_ip(char *ip_str, size_t max_len)
@@ -34,145 +67,419 @@ static bool get_local_ip(char *ip_str, size_t max_len)
     return true;
 }
 
-// Helper: Get current timestamp as formatted string
-static void get_timestamp(char *timestamp_str, size_t max_len)
+// Helper: Get local IPv4 address in network byte order (0 if unavailable)
+static uint32_t get_local_ip4(void)
+{
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    esp_netif_ip_info_t ip_info;
+    if (netif == NULL || esp_netif_get_ip_info(netif, &ip_info) != ESP_OK) {
+        return 0;
+    }
+    return ip_info.ip.addr;
+}
+
+// Helper: Get current time as milliseconds since the Unix epoch
+static int64_t get_epoch_ms(void)
 {
-    time_t now;
-    struct tm timeinfo;
-    time(&now);
-    localtime_r(&now, &timeinfo);
-    strftime(timestamp_str, max_len, "%d-%m-%Y %H:%M:%S", &timeinfo);
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
-// Helper: Read DHT11 sensor with interval control
-static void read_dht11_sensor(dht11_data_t *sensor_data)
+// Helper: Publish one encoded payload and log the outcome
+// Replayed payloads are never left in the RAM outbox: their flash copy is only
+// consumed once esp-mqtt has them, and the outbox policy could evict them first.
+static esp_err_t publish_payload(const char *topic, const void *payload, size_t len, const char *format,
+                                 int qos, bool replay)
 {
-    uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    
-    if (current_time - last_dht11_read >= CONFIG_DHT11_READ_INTERVAL) {
-        if (dht11_manager_read(sensor_data) == ESP_OK) {
-            last_dht11_read = current_time;
-            ESP_LOGD(TAG, "DHT11 read: Temp=%.1f°C, Humidity=%.1f%%", 
-                     sensor_data->temperature, sensor_data->humidity);
-        } else {
-            ESP_LOGW(TAG, "Failed to read DHT11, using cached data");
-            dht11_manager_get_cached(sensor_data);
-        }
-    } else {
-        // Use cached data to avoid polling too frequently
-        dht11_manager_get_cached(sensor_data);
+    int64_t start_us = esp_timer_get_time();
+    int msg_id = replay ? mqtt_manager_publish_bin_now(topic, payload, len, qos, 0)
+                        : mqtt_manager_publish_bin(topic, payload, len, qos, 0);
+    latency_record(LATENCY_STAGE_ENQUEUE, esp_timer_get_time() - start_us);
+
+    if (msg_id == -2) {
+        ESP_LOGD(TAG, "No room to replay %s message now", format);
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (msg_id == -1) {
+        ESP_LOGE(TAG, "Failed to publish %s message", format);
+        return ESP_FAIL;
     }
+
+    ESP_LOGI(TAG, "Message published successfully, msg_id=%d", msg_id);
+    ESP_LOGD(TAG, "Message details - Topic: %s, Format: %s, QoS: %d, Length: %u", 
+             topic, format, qos, (unsigned)len);
+    return ESP_OK;
 }
 
-// Helper: Read hygrometer sensor with interval control
-static void read_hygrometer_sensor(hygrometer_data_t *hygro_data)
+void mqtt_publisher_set_format(mqtt_payload_format_t format)
 {
-    uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    
-    if (current_time - last_hygro_read >= CONFIG_HYGROMETER_READ_INTERVAL) {
-        if (hygrometer_manager_read(hygro_data) == ESP_OK) {
-            last_hygro_read = current_time;
-            ESP_LOGD(TAG, "Hygrometer read: Moisture=%.1f%%", hygro_data->moisture_percent);
-        } else {
-            ESP_LOGW(TAG, "Failed to read hygrometer, using cached data");
-            hygrometer_manager_get_cached(hygro_data);
+    payload_format = format;
+}
+
+mqtt_payload_format_t mqtt_publisher_get_format(void)
+{
+    return payload_format;
+}
+
+// Helper: Decide whether a sample is worth publishing (deadband + heartbeat)
+static bool deadband_admit(const telemetry_sample_t *sample)
+{
+#if CONFIG_MQTT_DEADBAND_ENABLED
+    int64_t now_us = esp_timer_get_time();
+    bool heartbeat = deadband.have_last &&
+                     (now_us - deadband.last_sent_us) / 1000 >= CONFIG_MQTT_HEARTBEAT_MS;
+
+    if (deadband.have_last && !heartbeat &&
+        !telemetry_sample_exceeds_deadband(sample, &deadband.last_sent)) {
+        return false;
+    }
+
+    if (heartbeat && !telemetry_sample_exceeds_deadband(sample, &deadband.last_sent)) {
+        stats.heartbeats++;
+    }
+
+    deadband.last_sent = *sample;
+    deadband.last_sent_us = now_us;
+    deadband.have_last = true;
+#endif
+    stats.admitted++;
+    return true;
+}
+
+// Helper: Remove the n oldest samples (published or dropped)
+static void batch_consume(size_t n)
+{
+    batch.count -= n;
+    if (batch.count > 0) {
+        memmove(&batch.samples[0], &batch.samples[n], batch.count * sizeof(batch.samples[0]));
+        memmove(&batch.taken_us[0], &batch.taken_us[n], batch.count * sizeof(batch.taken_us[0]));
+    }
+}
+
+// Helper: Add a sample to the batch. When it is full while connected, the push replaces the
+// newest sample (latest value wins, the older history is kept; the next slot sends the batch);
+// offline without a store the oldest sample is dropped.
+static void batch_push(const telemetry_sample_t *sample, bool coalesce)
+{
+    if (batch.count == CONFIG_MQTT_BATCH_SIZE && coalesce) {
+        batch.samples[batch.count - 1] = *sample;
+        batch.taken_us[batch.count - 1] = esp_timer_get_time();
+        stats.coalesced++;
+        return;
+    }
+
+    if (batch.count == CONFIG_MQTT_BATCH_SIZE) {
+        batch_consume(1);
+        stats.dropped++;
+        ESP_LOGW(TAG, "Batch full while offline, dropped oldest sample (%lu total)",
+                 (unsigned long)stats.dropped);
+    }
+
+    batch.samples[batch.count] = *sample;
+    batch.taken_us[batch.count] = esp_timer_get_time();
+    batch.count++;
+}
+
+// Helper: Encode the n oldest samples in one format
+static size_t encode_batch(mqtt_payload_format_t format, const telemetry_sample_t *samples, size_t n,
+                           const char *ip_address, uint32_t ip4)
+{
+    if (format == MQTT_PAYLOAD_CBOR) {
+        return telemetry_encode_cbor((uint8_t *)payload_buf, sizeof(payload_buf), ip4, samples, n);
+    }
+    return telemetry_encode_json(payload_buf, sizeof(payload_buf), CONFIG_MQTT_CLIENT_ID,
+                                 ip_address, samples, n);
+}
+
+// Helper: Encode the largest prefix of the *n oldest samples that fits one
+// payload, halving on failure. The bytes stay in payload_buf for publishing;
+// every attempt counts towards the serialize stage.
+static size_t encode_fitting(mqtt_payload_format_t format, const telemetry_sample_t *samples, size_t *n,
+                             const char *ip_address, uint32_t ip4)
+{
+    int64_t start_us = esp_timer_get_time();
+    size_t len = encode_batch(format, samples, *n, ip_address, ip4);
+    while (len == 0 && *n > 1) {
+        *n /= 2;
+        len = encode_batch(format, samples, *n, ip_address, ip4);
+    }
+    latency_record(LATENCY_STAGE_SERIALIZE, esp_timer_get_time() - start_us);
+    return len;
+}
+
+// Helper: Publish the payload encoded in payload_buf in one format
+static esp_err_t publish_encoded(mqtt_payload_format_t format, size_t len, int qos, bool replay)
+{
+    if (format == MQTT_PAYLOAD_CBOR) {
+        // The client ID is carried by the topic, not the payload
+        return publish_payload(CONFIG_MQTT_CBOR_TOPIC, payload_buf, len, "CBOR", qos, replay);
+    }
+
+    ESP_LOGD(TAG, "Publishing JSON to topic '%s': %s", CONFIG_MQTT_TOPIC, payload_buf);
+    return publish_payload(CONFIG_MQTT_TOPIC, payload_buf, len, "JSON", qos, replay);
+}
+
+// Helper: Publish samples, as few messages as fit the payload buffer
+// *done counts the samples handled (published, or dropped because they can never fit),
+// which the caller removes from its queue even on error. Replayed samples are only
+// counted once esp-mqtt holds them (ESP_ERR_NOT_FINISHED while it cannot take them).
+static esp_err_t publish_samples(const telemetry_sample_t *samples, size_t count, int qos, bool replay,
+                                 size_t *done)
+{
+    int64_t start_us = esp_timer_get_time();
+    char ip_address[16] = "N/A";
+    get_local_ip(ip_address, sizeof(ip_address));
+    uint32_t ip4 = get_local_ip4();
+    latency_record(LATENCY_STAGE_IP_LOOKUP, esp_timer_get_time() - start_us);
+    mqtt_payload_format_t format = payload_format;
+
+    // With both formats, JSON (the larger encoding) sizes the message and
+    // CBOR carries the same samples
+    mqtt_payload_format_t primary = format == MQTT_PAYLOAD_CBOR ? MQTT_PAYLOAD_CBOR : MQTT_PAYLOAD_JSON;
+
+    *done = 0;
+    while (*done < count) {
+        const telemetry_sample_t *first = &samples[*done];
+
+        // Largest prefix of the remaining samples that fits in one payload
+        size_t n = count - *done;
+        size_t len = encode_fitting(primary, first, &n, ip_address, ip4);
+        if (len == 0) {
+            // Even a single sample does not fit: it can never be sent
+            ESP_LOGE(TAG, "Sample exceeds the %d-byte payload buffer, dropping it", CONFIG_MQTT_PAYLOAD_MAX);
+            (*done)++;
+            return ESP_ERR_NO_MEM;
         }
+
+        // Pulse LED while publishing
+        led_manager_pulse(CONFIG_LED_PULSE_MS);
+
+        esp_err_t err = publish_encoded(primary, len, qos, replay);
+        if (err != ESP_OK) {
+            return err;  // Keep the samples, retry on the next flush
+        }
+
+        if (format == MQTT_PAYLOAD_BOTH) {
+            // The samples count as sent once the JSON copy is accepted: retrying
+            // them for CBOR would publish the JSON again, so a failed CBOR copy is lost
+            int64_t cbor_start_us = esp_timer_get_time();
+            size_t cbor_len = encode_batch(MQTT_PAYLOAD_CBOR, first, n, ip_address, ip4);
+            latency_record(LATENCY_STAGE_SERIALIZE, esp_timer_get_time() - cbor_start_us);
+            if (cbor_len == 0 || publish_encoded(MQTT_PAYLOAD_CBOR, cbor_len, qos, replay) != ESP_OK) {
+                ESP_LOGW(TAG, "CBOR copy of %u sample(s) not published", (unsigned)n);
+            }
+        }
+
+        if (n > 1) {
+            ESP_LOGD(TAG, "Published batch of %u samples", (unsigned)n);
+        }
+        stats.messages++;
+        stats.published += n;
+        if (qos < CONFIG_MQTT_QOS) {
+            stats.downgraded++;
+        }
+        *done += n;
+    }
+
+    return ESP_OK;
+}
+
+// Helper: Publish every pending sample
+static esp_err_t flush_batch(int qos)
+{
+    size_t done = 0;
+    esp_err_t err = publish_samples(batch.samples, batch.count, qos, false, &done);
+    batch_consume(done);
+    return err;
+}
+
+// Helper: Move a sample to the offline store (MQTT down)
+static void store_offline(const telemetry_sample_t *sample)
+{
+    if (offline_store_append(sample) == ESP_OK) {
+        stats.stored++;
     } else {
-        // Use cached data to avoid polling ADC too frequently
-        hygrometer_manager_get_cached(hygro_data);
+        stats.dropped++;
     }
 }
 
-// Helper: Build JSON payload from sensor data
-static char* build_json_payload(const char *client_id, const char *ip, const char *timestamp,
-                                 const dht11_data_t *dht11, const hygrometer_data_t *hygro)
+// Helper: Move everything queued in RAM to the offline store, then the new sample
+static esp_err_t spill_offline(const telemetry_sample_t *sample)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
-        ESP_LOGE(TAG, "Failed to create JSON root");
-        return NULL;
+    for (size_t i = 0; i < batch.count; i++) {
+        store_offline(&batch.samples[i]);
     }
+    batch.count = 0;
 
-    // Add metadata
-    cJSON_AddStringToObject(root, "client_id", client_id);
-    cJSON_AddStringToObject(root, "ip", ip);
-    cJSON_AddStringToObject(root, "timestamp", timestamp);
+    if (sample) {
+        store_offline(sample);
+    }
 
-    // Add DHT11 data
-    if (dht11->valid) {
-        cJSON_AddNumberToObject(root, "temperature_c", dht11->temperature);
-        cJSON_AddNumberToObject(root, "humidity_pct", dht11->humidity);
-    } else {
-        cJSON_AddNullToObject(root, "temperature_c");
-        cJSON_AddNullToObject(root, "humidity_pct");
+    ESP_LOGD(TAG, "MQTT not connected, %lu sample(s) stored offline",
+             (unsigned long)offline_store_pending());
+    return ESP_ERR_INVALID_STATE;
+}
+
+// Helper: Replay a bounded number of stored samples, oldest first
+// The per-cycle cap keeps the backlog from starving live data and the broker.
+static esp_err_t drain_offline(void)
+{
+    static telemetry_sample_t replay[CONFIG_OFFLINE_STORE_DRAIN_PER_CYCLE];
+
+    if (!offline_store_ready() || offline_store_pending() == 0) {
+        return ESP_OK;
     }
 
-    // Add hygrometer data
-    if (hygro->valid) {
-        cJSON_AddNumberToObject(root, "moisture_pct", hygro->moisture_percent);
-    } else {
-        cJSON_AddNullToObject(root, "moisture_pct");
+    size_t count = 0;
+    esp_err_t err = offline_store_peek(replay, CONFIG_OFFLINE_STORE_DRAIN_PER_CYCLE, &count);
+    if (err != ESP_OK || count == 0) {
+        return err;
     }
 
-    // Serialize to string
-    char *json_str = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    
-    return json_str;
+    size_t done = 0;
+    err = publish_samples(replay, count, CONFIG_MQTT_QOS, true, &done);
+    if (done > 0) {
+        offline_store_consume(done);
+        stats.replayed += done;
+        ESP_LOGI(TAG, "Replayed %u stored sample(s), %lu left", (unsigned)done,
+                 (unsigned long)offline_store_pending());
+    }
+    // No room in the window: the rest stays on flash for the next cycle
+    return err == ESP_ERR_NOT_FINISHED ? ESP_OK : err;
 }
 
-esp_err_t mqtt_publish_sensor_data(void)
+void mqtt_publisher_get_stats(mqtt_publisher_stats_t *out)
+{
+    if (out) {
+        *out = stats;
+        out->stretch = backoff.stretch;
+    }
+}
+
+esp_err_t mqtt_publisher_flush(void)
 {
-    // Check MQTT connection
     if (!mqtt_manager_is_connected()) {
+        // Nothing is lost across the restart if it is on flash
+        if (offline_store_ready()) {
+            spill_offline(NULL);
+            return offline_store_flush();
+        }
+        return batch.count == 0 ? ESP_OK : ESP_ERR_INVALID_STATE;
+    }
+    if (batch.count == 0) {
+        return ESP_OK;
+    }
+    return flush_batch(CONFIG_MQTT_QOS);
+}
+
+// Helper: Advance the backpressure cycle; returns true on a flush slot
+// The stretch doubles while the pressure stays at or above the high mark and halves
+// back once it falls to the low mark, so the publish rate adapts to the broker.
+static bool backoff_slot(uint32_t pressure)
+{
+    if (++backoff.cycle < backoff.stretch) {
+        return false;
+    }
+    backoff.cycle = 0;
+
+    if (pressure >= CONFIG_MQTT_BACKPRESSURE_HIGH_PCT &&
+        backoff.stretch < CONFIG_MQTT_BACKPRESSURE_MAX_STRETCH) {
+        backoff.stretch *= 2;
+        ESP_LOGW(TAG, "MQTT backpressure %lu%%, publishing every %lu cycles",
+                 (unsigned long)pressure, (unsigned long)backoff.stretch);
+    } else if (pressure <= CONFIG_MQTT_BACKPRESSURE_LOW_PCT && backoff.stretch > 1) {
+        backoff.stretch /= 2;
+        ESP_LOGI(TAG, "MQTT backpressure %lu%%, publishing every %lu cycle(s)",
+                 (unsigned long)pressure, (unsigned long)backoff.stretch);
+    }
+    return true;
+}
+
+// One publish cycle: sample, admit, queue or store, flush, replay
+static esp_err_t publish_cycle(void)
+{
+    bool connected = mqtt_manager_is_connected();
+    bool offline_store = offline_store_ready();
+
+    // Without batching or the offline store there is nowhere to keep a sample while offline
+    if (!connected && CONFIG_MQTT_BATCH_SIZE == 1 && !offline_store) {
         ESP_LOGW(TAG, "MQTT not connected, skipping publish");
         return ESP_ERR_INVALID_STATE;
     }
 
     ESP_LOGD(TAG, "Starting sensor data collection and publish...");
 
-    // Read sensors
-    dht11_data_t dht11_data = {0};
-    hygrometer_data_t hygro_data = {0};
-    read_dht11_sensor(&dht11_data);
-    read_hygrometer_sensor(&hygro_data);
+    // Latest readings from the sampling tasks; never waits on sensor hardware
+    dht11_data_t dht11_data[CONFIG_DHT11_MAX_SENSORS] = {0};
+    hygrometer_data_t hygro_data[CONFIG_HYGROMETER_MAX_PROBES] = {0};
+    size_t dht11_count = sensor_sampler_get_dht11(dht11_data, CONFIG_DHT11_MAX_SENSORS, NULL);
+    size_t hygro_count = sensor_sampler_get_hygrometer(hygro_data, CONFIG_HYGROMETER_MAX_PROBES, NULL);
 
-    // Get metadata
-    char ip_address[16] = "N/A";
-    char timestamp[64];
-    get_local_ip(ip_address, sizeof(ip_address));
-    get_timestamp(timestamp, sizeof(timestamp));
+    int64_t start_us = esp_timer_get_time();
+    int64_t timestamp_ms = get_epoch_ms();
+    latency_record(LATENCY_STAGE_TIMESTAMP, esp_timer_get_time() - start_us);
 
-    ESP_LOGD(TAG, "IP: %s, Timestamp: %s", ip_address, timestamp);
+    telemetry_sample_t sample;
+    telemetry_sample_fill(&sample, timestamp_ms, dht11_data, dht11_count, hygro_data, hygro_count);
+    stats.samples++;
 
-    // Build JSON payload
-    char *json_str = build_json_payload(CONFIG_MQTT_CLIENT_ID, ip_address, timestamp,
-                                         &dht11_data, &hygro_data);
-    if (!json_str) {
-        ESP_LOGE(TAG, "Failed to build JSON payload");
-        return ESP_ERR_NO_MEM;
+    if (!deadband_admit(&sample)) {
+        stats.suppressed++;
+        ESP_LOGD(TAG, "Sample within deadband, not published (%lu suppressed)",
+                 (unsigned long)stats.suppressed);
+        // A pending batch or the offline backlog may still be due
+        if (!connected) {
+            return ESP_OK;
+        }
+    } else if (!connected && offline_store) {
+        return spill_offline(&sample);
+    } else {
+        batch_push(&sample, connected);
     }
 
-    ESP_LOGD(TAG, "Publishing JSON to topic '%s': %s", CONFIG_MQTT_TOPIC, json_str);
+    if (!connected) {
+        ESP_LOGD(TAG, "MQTT not connected, %u sample(s) pending", (unsigned)batch.count);
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    // Pulse LED while publishing
-    led_manager_pulse(CONFIG_LED_PULSE_MS);
+    mqtt_manager_process_outbox();
+    uint32_t pressure = mqtt_manager_get_pressure();
+    if (!backoff_slot(pressure)) {
+        return ESP_OK;  // Stretched interval: samples coalesce until the next slot
+    }
 
-    // Publish to MQTT
-    int msg_id = mqtt_manager_publish(CONFIG_MQTT_TOPIC, json_str, CONFIG_MQTT_QOS, 0);
-    
-    esp_err_t result = ESP_OK;
-    if (msg_id != -1) {
-        ESP_LOGI(TAG, "Message published successfully, msg_id=%d", msg_id);
-        ESP_LOGD(TAG, "Message details - Topic: %s, QoS: %d, Length: %d", 
-                 CONFIG_MQTT_TOPIC, CONFIG_MQTT_QOS, strlen(json_str));
-    } else {
-        ESP_LOGE(TAG, "Failed to publish message");
-        result = ESP_FAIL;
+    // A full outbox takes no more QoS > 0 messages without dropping: fall back to QoS 0, or hold the samples
+    int qos = CONFIG_MQTT_QOS;
+    if (pressure >= 100) {
+        if (!CONFIG_MQTT_BACKPRESSURE_QOS0) {
+            return ESP_OK;
+        }
+        qos = 0;
     }
 
-    // Cleanup
-    cJSON_free(json_str);
+    // Flush on a full batch or once the oldest sample has waited long enough
+    int64_t waited_ms = (esp_timer_get_time() - batch.taken_us[0]) / 1000;
+    if (batch.count > 0 &&
+        (batch.count >= CONFIG_MQTT_BATCH_SIZE || waited_ms >= CONFIG_MQTT_BATCH_MAX_LATENCY_MS ||
+         backoff.stretch > 1)) {
+        esp_err_t err = flush_batch(qos);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
 
-    return result;
+    // Live data first, then catch up on what was stored while offline (only with headroom)
+    if (pressure >= CONFIG_MQTT_BACKPRESSURE_HIGH_PCT) {
+        return ESP_OK;
+    }
+    return drain_offline();
+}
+
+esp_err_t mqtt_publish_sensor_data(void)
+{
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = publish_cycle();
+    latency_record(LATENCY_STAGE_CYCLE, esp_timer_get_time() - start_us);
+    return err;
 }
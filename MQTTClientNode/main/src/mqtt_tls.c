@@ -0,0 +1,273 @@
+#include "mqtt_tls.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_tls.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "latency_stats.h"
+#include "lwip/sockets.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "MQTT_TLS";
+
+// Session resumption needs esp-tls built with client session ticket support
+#if CONFIG_MQTT_TLS_SESSION_RESUMPTION && defined(CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS)
+#define MQTT_TLS_RESUMPTION 1
+#else
+#define MQTT_TLS_RESUMPTION 0
+#endif
+
+#define MQTT_TLS_HOST_MAX 64
+
+// One connection at a time: esp-mqtt owns a single transport
+static struct {
+    esp_tls_t *tls;                         // Open connection, NULL when closed
+    char host[MQTT_TLS_HOST_MAX];           // Peer of the open connection
+    int port;
+    esp_tls_client_session_t *session;      // Cached across reconnects
+    char session_host[MQTT_TLS_HOST_MAX];   // Peer that issued the cached session
+    int session_port;
+    mqtt_tls_stats_t stats;
+} tls_ctx;
+
+// Helper: Keep the session of the open connection for the next connect.
+// Taken at close rather than right after the handshake so that TLS 1.3
+// tickets, which arrive after it, are included.
+static void session_save(void)
+{
+#if MQTT_TLS_RESUMPTION
+    esp_tls_client_session_t *session = esp_tls_get_client_session(tls_ctx.tls);
+    if (session == NULL) {
+        return;
+    }
+    if (tls_ctx.session != NULL) {
+        esp_tls_free_client_session(tls_ctx.session);
+    }
+    tls_ctx.session = session;
+    strcpy(tls_ctx.session_host, tls_ctx.host);
+    tls_ctx.session_port = tls_ctx.port;
+    tls_ctx.stats.session_cached = 1;
+#endif
+}
+
+// Helper: Forget the cached session (rejected, or the server keys changed)
+static void session_drop(void)
+{
+#if MQTT_TLS_RESUMPTION
+    if (tls_ctx.session != NULL) {
+        esp_tls_free_client_session(tls_ctx.session);
+        tls_ctx.session = NULL;
+    }
+    tls_ctx.stats.session_cached = 0;
+#endif
+}
+
+// Helper: Whether the cached session was issued by host:port. A session is
+// only valid with the server that issued it: offered to another broker after
+// a failover it is declined and the handshake is a full one.
+static bool session_matches(const char *host, int port)
+{
+    return tls_ctx.session != NULL && tls_ctx.session_port == port &&
+           strcmp(tls_ctx.session_host, host) == 0;
+}
+
+// Helper: Whether a failed connect failed in the TLS layer. DNS, TCP connect
+// and timeout failures (typical while a broker restarts) say nothing about
+// the cached session, so it is kept for the attempt that gets through.
+static bool failed_in_tls(void)
+{
+    esp_tls_error_handle_t err = NULL;
+    if (esp_tls_get_error_handle(tls_ctx.tls, &err) != ESP_OK || err == NULL) {
+        return false;
+    }
+    return err->last_error == ESP_ERR_MBEDTLS_SSL_HANDSHAKE_FAILED;
+}
+
+static int tls_close(esp_transport_handle_t t)
+{
+    if (tls_ctx.tls == NULL) {
+        return 0;
+    }
+    session_save();
+    esp_tls_conn_destroy(tls_ctx.tls);
+    tls_ctx.tls = NULL;
+    return 0;
+}
+
+static int tls_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms)
+{
+    tls_close(t);
+
+    if (strlen(host) >= sizeof(tls_ctx.host)) {
+        ESP_LOGE(TAG, "Host name too long: %s", host);
+        return -1;
+    }
+    strcpy(tls_ctx.host, host);
+    tls_ctx.port = port;
+
+    tls_ctx.tls = esp_tls_init();
+    if (tls_ctx.tls == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate TLS connection");
+        return -1;
+    }
+
+    esp_tls_cfg_t cfg = {
+        .timeout_ms = timeout_ms,
+        .common_name = CONFIG_MQTT_TLS_COMMON_NAME,
+    };
+    const char *ca_pem = CONFIG_MQTT_TLS_CA_PEM;
+    if (ca_pem != NULL) {
+        cfg.cacert_buf = (const unsigned char *)ca_pem;
+        cfg.cacert_bytes = strlen(ca_pem) + 1;
+    } else {
+        cfg.crt_bundle_attach = esp_crt_bundle_attach;
+    }
+    bool resumed = false;
+#if MQTT_TLS_RESUMPTION
+    // Another broker's session is not offered; it is replaced when this connection closes
+    resumed = session_matches(host, port);
+    cfg.client_session = resumed ? tls_ctx.session : NULL;
+#endif
+
+    // Low-water mark of this handshake alone, not of the whole uptime, so the
+    // resumed and full peaks are comparable
+    uint32_t free_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    bool monitored = heap_caps_monitor_local_minimum_free_size_start() == ESP_OK;
+    int64_t start_us = esp_timer_get_time();
+
+    int ret = esp_tls_conn_new_sync(host, strlen(host), port, &cfg, tls_ctx.tls);
+
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    uint32_t low = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    if (monitored) {
+        low = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+        heap_caps_monitor_local_minimum_free_size_stop();
+    }
+    uint32_t drawn = free_before > low ? free_before - low : 0;
+
+    if (ret != 1) {
+        bool drop = resumed && failed_in_tls();
+        ESP_LOGE(TAG, "TLS connect to %s:%d failed after %lld ms%s", host, port,
+                 (long long)(elapsed_us / 1000), drop ? " (dropping cached session)" : "");
+        tls_ctx.stats.failures++;
+        if (drop) {
+            session_drop();
+        }
+        esp_tls_conn_destroy(tls_ctx.tls);
+        tls_ctx.tls = NULL;
+        return -1;
+    }
+
+    if (resumed) {
+        tls_ctx.stats.resumed++;
+        if (drawn > tls_ctx.stats.resumed_heap_peak) {
+            tls_ctx.stats.resumed_heap_peak = drawn;
+        }
+        latency_record(LATENCY_STAGE_TLS_RESUMED, elapsed_us);
+    } else {
+        tls_ctx.stats.full++;
+        if (drawn > tls_ctx.stats.full_heap_peak) {
+            tls_ctx.stats.full_heap_peak = drawn;
+        }
+        latency_record(LATENCY_STAGE_TLS_FULL, elapsed_us);
+    }
+    ESP_LOGI(TAG, "TLS %s handshake with %s:%d in %lld ms, heap drawn %lu bytes",
+             resumed ? "resumed" : "full", host, port, (long long)(elapsed_us / 1000),
+             (unsigned long)drawn);
+    return 0;
+}
+
+// Helper: Wait until the socket is readable (read) or writable (!read)
+static int tls_poll(bool read, int timeout_ms)
+{
+    int fd = -1;
+    if (tls_ctx.tls == NULL || esp_tls_get_conn_sockfd(tls_ctx.tls, &fd) != ESP_OK || fd < 0) {
+        return -1;
+    }
+
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int ret = select(fd + 1, read ? &fds : NULL, read ? NULL : &fds, NULL, timeout_ms < 0 ? NULL : &tv);
+    return ret < 0 ? -1 : ret;
+}
+
+static int tls_poll_read(esp_transport_handle_t t, int timeout_ms)
+{
+    // Records already decrypted by mbedTLS never show up on the socket
+    if (tls_ctx.tls != NULL && esp_tls_get_bytes_avail(tls_ctx.tls) > 0) {
+        return 1;
+    }
+    return tls_poll(true, timeout_ms);
+}
+
+static int tls_poll_write(esp_transport_handle_t t, int timeout_ms)
+{
+    return tls_poll(false, timeout_ms);
+}
+
+static int tls_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
+{
+    int poll = tls_poll_read(t, timeout_ms);
+    if (poll <= 0) {
+        return poll == 0 ? ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT : ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+
+    ssize_t ret = esp_tls_conn_read(tls_ctx.tls, buffer, len);
+    if (ret == ESP_TLS_ERR_SSL_WANT_READ || ret == ESP_TLS_ERR_SSL_WANT_WRITE) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    if (ret == 0) {
+        return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    }
+    return ret < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : (int)ret;
+}
+
+static int tls_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms)
+{
+    int poll = tls_poll_write(t, timeout_ms);
+    if (poll <= 0) {
+        return poll == 0 ? ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT : ERR_TCP_TRANSPORT_CONNECTION_FAILED;
+    }
+
+    ssize_t ret = esp_tls_conn_write(tls_ctx.tls, buffer, len);
+    if (ret == ESP_TLS_ERR_SSL_WANT_READ || ret == ESP_TLS_ERR_SSL_WANT_WRITE) {
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    }
+    return ret < 0 ? ERR_TCP_TRANSPORT_CONNECTION_FAILED : (int)ret;
+}
+
+static int tls_destroy(esp_transport_handle_t t)
+{
+    return tls_close(t);
+}
+
+esp_transport_handle_t mqtt_tls_transport_create(void)
+{
+    esp_transport_handle_t t = esp_transport_init();
+    if (t == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate transport");
+        return NULL;
+    }
+
+    esp_transport_set_func(t, tls_connect, tls_read, tls_write, tls_close,
+                           tls_poll_read, tls_poll_write, tls_destroy);
+    esp_transport_set_default_port(t, 8883);
+
+    ESP_LOGI(TAG, "TLS transport ready, session resumption %s",
+             MQTT_TLS_RESUMPTION ? "enabled" : "disabled");
+    return t;
+}
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *stats)
+{
+    if (stats) {
+        *stats = tls_ctx.stats;
+    }
+}
@@ -0,0 +1,373 @@
+#include "offline_store.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include <stddef.h>
+#include <string.h>
+
+static const char *TAG = "OFFLINE_STORE";
+
+#define OFFLINE_SECTOR_SIZE       SPI_FLASH_SEC_SIZE
+#define OFFLINE_RECORD_MAGIC      0xA5
+#define OFFLINE_CONSUMED_PENDING  0xFF   // Erased state
+#define OFFLINE_CONSUMED_DONE     0x00   // Programmed in place once published
+#define OFFLINE_SCAN_CHUNK        8      // Records read per flash access during recovery
+
+// One sample on flash. consumed is the last header byte so it can be
+// programmed on its own.
+typedef struct {
+    uint32_t seq;                 // Monotonic record number
+    uint16_t crc;                 // CRC16 of seq and sample
+    uint8_t magic;                // OFFLINE_RECORD_MAGIC once written
+    uint8_t consumed;             // OFFLINE_CONSUMED_PENDING / OFFLINE_CONSUMED_DONE
+    telemetry_sample_t sample;
+} offline_record_t;
+
+#define OFFLINE_RECORDS_PER_SECTOR (OFFLINE_SECTOR_SIZE / sizeof(offline_record_t))
+
+_Static_assert(OFFLINE_SECTOR_SIZE % sizeof(offline_record_t) == 0,
+               "offline_record_t must divide a flash sector (adjust sensor limits or pad the record)");
+_Static_assert(CONFIG_OFFLINE_STORE_WRITE_BATCH > 0 &&
+               CONFIG_OFFLINE_STORE_WRITE_BATCH <= OFFLINE_RECORDS_PER_SECTOR,
+               "CONFIG_OFFLINE_STORE_WRITE_BATCH must be 1..records per sector");
+
+static struct {
+    const esp_partition_t *part;
+    uint32_t num_slots;
+    uint32_t head;            // Next slot to program
+    uint32_t tail;            // Oldest slot that may hold an unpublished record
+    uint32_t next_seq;
+    uint32_t on_flash;        // Unpublished records on flash
+    offline_record_t staging[CONFIG_OFFLINE_STORE_WRITE_BATCH];
+    size_t staged;
+    offline_store_stats_t stats;
+} store = {
+    .part = NULL
+};
+
+static inline size_t slot_offset(uint32_t slot)
+{
+    return (size_t)slot * sizeof(offline_record_t);
+}
+
+static inline uint32_t next_slot(uint32_t slot)
+{
+    return (slot + 1) % store.num_slots;
+}
+
+static uint16_t record_crc(const offline_record_t *rec)
+{
+    uint16_t crc = esp_rom_crc16_le(0, (const uint8_t *)&rec->seq, sizeof(rec->seq));
+    return esp_rom_crc16_le(crc, (const uint8_t *)&rec->sample, sizeof(rec->sample));
+}
+
+static inline bool record_valid(const offline_record_t *rec)
+{
+    return rec->magic == OFFLINE_RECORD_MAGIC && rec->crc == record_crc(rec);
+}
+
+static inline bool record_pending(const offline_record_t *rec)
+{
+    return record_valid(rec) && rec->consumed == OFFLINE_CONSUMED_PENDING;
+}
+
+static bool record_blank(const offline_record_t *rec)
+{
+    const uint8_t *p = (const uint8_t *)rec;
+    for (size_t i = 0; i < sizeof(*rec); i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static esp_err_t read_record(uint32_t slot, offline_record_t *rec)
+{
+    return esp_partition_read(store.part, slot_offset(slot), rec, sizeof(*rec));
+}
+
+// Rebuild head, tail and the pending count from the record headers
+static esp_err_t offline_store_recover(void)
+{
+    static offline_record_t chunk[OFFLINE_SCAN_CHUNK];
+    bool found = false;
+    uint32_t max_seq = 0, max_slot = 0;
+    uint32_t min_pending_seq = UINT32_MAX, min_pending_slot = 0;
+
+    store.on_flash = 0;
+    for (uint32_t slot = 0; slot < store.num_slots; slot += OFFLINE_SCAN_CHUNK) {
+        uint32_t n = store.num_slots - slot < OFFLINE_SCAN_CHUNK ? store.num_slots - slot : OFFLINE_SCAN_CHUNK;
+        esp_err_t err = esp_partition_read(store.part, slot_offset(slot), chunk, n * sizeof(offline_record_t));
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            if (!record_valid(&chunk[i])) {
+                continue;
+            }
+            if (!found || chunk[i].seq > max_seq) {
+                max_seq = chunk[i].seq;
+                max_slot = slot + i;
+                found = true;
+            }
+            if (chunk[i].consumed == OFFLINE_CONSUMED_PENDING) {
+                store.on_flash++;
+                if (chunk[i].seq < min_pending_seq) {
+                    min_pending_seq = chunk[i].seq;
+                    min_pending_slot = slot + i;
+                }
+            }
+        }
+    }
+
+    store.head = found ? next_slot(max_slot) : 0;
+    store.next_seq = found ? max_seq + 1 : 0;
+
+    // A record torn by a power cut sits where the next write would go:
+    // abandon the rest of that sector, it gets erased on the next lap
+    if (store.head % OFFLINE_RECORDS_PER_SECTOR != 0) {
+        offline_record_t rec;
+        esp_err_t err = read_record(store.head, &rec);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (!record_blank(&rec)) {
+            ESP_LOGW(TAG, "Partial record at slot %lu, skipping to the next sector",
+                     (unsigned long)store.head);
+            uint32_t sector = store.head / OFFLINE_RECORDS_PER_SECTOR + 1;
+            store.head = (sector * OFFLINE_RECORDS_PER_SECTOR) % store.num_slots;
+        }
+    }
+
+    store.tail = store.on_flash > 0 ? min_pending_slot : store.head;
+    return ESP_OK;
+}
+
+esp_err_t offline_store_init(void)
+{
+    if (store.part) {
+        ESP_LOGW(TAG, "Offline store already initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           CONFIG_OFFLINE_STORE_PARTITION_SUBTYPE,
+                                                           CONFIG_OFFLINE_STORE_PARTITION);
+    if (part == NULL) {
+        ESP_LOGE(TAG, "Partition '%s' not found (check partitions.csv)", CONFIG_OFFLINE_STORE_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint32_t sectors = part->size / OFFLINE_SECTOR_SIZE;
+    if (sectors < 2) {
+        ESP_LOGE(TAG, "Partition '%s' too small (%lu bytes, need 2 sectors)",
+                 CONFIG_OFFLINE_STORE_PARTITION, (unsigned long)part->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    memset(&store.stats, 0, sizeof(store.stats));
+    store.part = part;
+    store.num_slots = sectors * OFFLINE_RECORDS_PER_SECTOR;
+    store.staged = 0;
+
+    esp_err_t err = offline_store_recover();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to scan offline store: %s", esp_err_to_name(err));
+        store.part = NULL;
+        return err;
+    }
+
+    ESP_LOGI(TAG, "Offline store ready: %lu sectors, %lu records, %lu pending",
+             (unsigned long)sectors, (unsigned long)store.num_slots, (unsigned long)store.on_flash);
+    return ESP_OK;
+}
+
+bool offline_store_ready(void)
+{
+    return store.part != NULL;
+}
+
+// Erase the sector starting at the head slot, dropping its unpublished records
+static esp_err_t erase_head_sector(void)
+{
+    uint32_t sector = store.head / OFFLINE_RECORDS_PER_SECTOR;
+    uint32_t first = sector * OFFLINE_RECORDS_PER_SECTOR;
+
+    // Count what the wrap destroys (only possible when the ring is full)
+    if (store.on_flash > 0) {
+        static offline_record_t chunk[OFFLINE_SCAN_CHUNK];
+        uint32_t lost = 0;
+        for (uint32_t i = 0; i < OFFLINE_RECORDS_PER_SECTOR; i += OFFLINE_SCAN_CHUNK) {
+            if (esp_partition_read(store.part, slot_offset(first + i), chunk, sizeof(chunk)) != ESP_OK) {
+                continue;
+            }
+            for (uint32_t j = 0; j < OFFLINE_SCAN_CHUNK; j++) {
+                lost += record_pending(&chunk[j]);
+            }
+        }
+        if (lost > 0) {
+            store.on_flash -= lost;
+            store.stats.overwritten += lost;
+            ESP_LOGW(TAG, "Store full, dropped %lu oldest samples", (unsigned long)lost);
+        }
+        // The oldest data is gone: continue from the following sector
+        if (store.tail / OFFLINE_RECORDS_PER_SECTOR == sector) {
+            store.tail = (first + OFFLINE_RECORDS_PER_SECTOR) % store.num_slots;
+        }
+    }
+
+    esp_err_t err = esp_partition_erase_range(store.part, first * sizeof(offline_record_t), OFFLINE_SECTOR_SIZE);
+    if (err != ESP_OK) {
+        store.stats.write_errors++;
+        ESP_LOGE(TAG, "Sector erase failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    store.stats.sector_erases++;
+    return ESP_OK;
+}
+
+esp_err_t offline_store_flush(void)
+{
+    if (!store.part) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    size_t done = 0;
+    while (done < store.staged) {
+        if (store.head % OFFLINE_RECORDS_PER_SECTOR == 0) {
+            esp_err_t err = erase_head_sector();
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+
+        // Program as many staged records as fit before the sector ends
+        size_t room = OFFLINE_RECORDS_PER_SECTOR - store.head % OFFLINE_RECORDS_PER_SECTOR;
+        size_t n = store.staged - done < room ? store.staged - done : room;
+        esp_err_t err = esp_partition_write(store.part, slot_offset(store.head),
+                                            &store.staging[done], n * sizeof(offline_record_t));
+        if (err != ESP_OK) {
+            store.stats.write_errors++;
+            ESP_LOGE(TAG, "Record write failed: %s", esp_err_to_name(err));
+            memmove(&store.staging[0], &store.staging[done], (store.staged - done) * sizeof(offline_record_t));
+            store.staged -= done;
+            return err;
+        }
+
+        if (store.on_flash == 0) {
+            store.tail = store.head;
+        }
+        store.head = (store.head + n) % store.num_slots;
+        store.on_flash += n;
+        done += n;
+    }
+
+    store.staged = 0;
+    return ESP_OK;
+}
+
+esp_err_t offline_store_append(const telemetry_sample_t *sample)
+{
+    if (!store.part) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    offline_record_t *rec = &store.staging[store.staged++];
+    memset(rec, 0xFF, sizeof(*rec));
+    rec->seq = store.next_seq++;
+    rec->sample = *sample;
+    rec->magic = OFFLINE_RECORD_MAGIC;
+    rec->consumed = OFFLINE_CONSUMED_PENDING;
+    rec->crc = record_crc(rec);
+    store.stats.appended++;
+
+    if (store.staged < CONFIG_OFFLINE_STORE_WRITE_BATCH) {
+        return ESP_OK;
+    }
+    return offline_store_flush();
+}
+
+uint32_t offline_store_pending(void)
+{
+    return store.on_flash + store.staged;
+}
+
+esp_err_t offline_store_peek(telemetry_sample_t *samples, size_t max_samples, size_t *num_samples)
+{
+    if (!store.part) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (samples == NULL || num_samples == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *num_samples = 0;
+
+    if (store.staged > 0) {
+        esp_err_t err = offline_store_flush();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    uint32_t slot = store.tail;
+    uint32_t left = store.on_flash;
+    while (left > 0 && *num_samples < max_samples && slot != store.head) {
+        offline_record_t rec;
+        esp_err_t err = read_record(slot, &rec);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (record_pending(&rec)) {
+            samples[(*num_samples)++] = rec.sample;
+            left--;
+        }
+        slot = next_slot(slot);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t offline_store_consume(size_t count)
+{
+    if (!store.part) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    static const uint8_t done_flag = OFFLINE_CONSUMED_DONE;
+    while (count > 0 && store.on_flash > 0 && store.tail != store.head) {
+        offline_record_t rec;
+        esp_err_t err = read_record(store.tail, &rec);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (record_pending(&rec)) {
+            // 0xFF -> 0x00 needs no erase
+            err = esp_partition_write(store.part, slot_offset(store.tail) + offsetof(offline_record_t, consumed),
+                                      &done_flag, sizeof(done_flag));
+            if (err != ESP_OK) {
+                store.stats.write_errors++;
+                return err;
+            }
+            store.on_flash--;
+            store.stats.drained++;
+            count--;
+        }
+        store.tail = next_slot(store.tail);
+    }
+
+    if (store.on_flash == 0) {
+        store.tail = store.head;
+    }
+    return ESP_OK;
+}
+
+void offline_store_get_stats(offline_store_stats_t *stats)
+{
+    if (stats) {
+        *stats = store.stats;
+        stats->pending = offline_store_pending();
+    }
+}
@@ -0,0 +1,188 @@
+#include "scheduler.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "SCHEDULER";
+
+typedef struct {
+    scheduler_job_config_t config;
+    TaskHandle_t task;
+    esp_timer_handle_t timer;       // One-shot, re-armed for every deadline
+    int64_t deadline_us;            // Next absolute deadline
+    scheduler_job_stats_t stats;
+} scheduler_job_t;
+
+static struct {
+    scheduler_job_t jobs[CONFIG_SCHEDULER_MAX_JOBS];
+    size_t num_jobs;
+    portMUX_TYPE lock;
+} sched = {
+    .num_jobs = 0,
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+// First deadline on the job's grid that is not in the past
+static int64_t first_deadline(const scheduler_job_t *job, int64_t now_us)
+{
+    int64_t period_us = (int64_t)job->config.period_ms * 1000;
+    int64_t phase_us = (int64_t)job->config.phase_ms * 1000;
+    if (now_us <= phase_us) {
+        return phase_us;
+    }
+    int64_t periods = (now_us - phase_us + period_us - 1) / period_us;
+    return phase_us + periods * period_us;
+}
+
+static void scheduler_timer_cb(void *arg)
+{
+    scheduler_job_t *job = (scheduler_job_t *)arg;
+    xTaskNotifyGive(job->task);
+}
+
+// Sleep until the job's deadline (returns at once if it already passed)
+static void wait_for_deadline(scheduler_job_t *job)
+{
+    int64_t wait_us = job->deadline_us - esp_timer_get_time();
+    if (wait_us <= 0) {
+        return;
+    }
+    if (esp_timer_start_once(job->timer, (uint64_t)wait_us) != ESP_OK) {
+        // Fall back to tick resolution
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000) + 1);
+        return;
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static void scheduler_job_task(void *arg)
+{
+    scheduler_job_t *job = (scheduler_job_t *)arg;
+    int64_t period_us = (int64_t)job->config.period_ms * 1000;
+
+    job->deadline_us = first_deadline(job, esp_timer_get_time());
+
+    while (true) {
+        wait_for_deadline(job);
+
+        int64_t start_us = esp_timer_get_time();
+        job->config.fn(job->config.arg);
+        int64_t end_us = esp_timer_get_time();
+
+        // Next deadline on the grid; skip those the run overran
+        int64_t next_us = job->deadline_us + period_us;
+        uint32_t missed = 0;
+        if (end_us > next_us) {
+            missed = (uint32_t)((end_us - next_us + period_us - 1) / period_us);
+            next_us += (int64_t)missed * period_us;
+        }
+
+        int64_t jitter_us = start_us - job->deadline_us;
+        int64_t runtime_us = end_us - start_us;
+        portENTER_CRITICAL(&sched.lock);
+        job->stats.runs++;
+        job->stats.missed += missed;
+        job->stats.last_jitter_us = jitter_us;
+        job->stats.total_jitter_us += jitter_us;
+        if (jitter_us > job->stats.max_jitter_us) {
+            job->stats.max_jitter_us = jitter_us;
+        }
+        job->stats.last_runtime_us = runtime_us;
+        if (runtime_us > job->stats.max_runtime_us) {
+            job->stats.max_runtime_us = runtime_us;
+        }
+        portEXIT_CRITICAL(&sched.lock);
+
+        if (missed > 0) {
+            ESP_LOGW(TAG, "Job '%s' ran %lldms, missed %lu deadline(s)",
+                     job->config.name, (long long)(runtime_us / 1000), (unsigned long)missed);
+        }
+        job->deadline_us = next_us;
+    }
+}
+
+esp_err_t scheduler_add_job(const scheduler_job_config_t *config, int *job_id)
+{
+    if (config == NULL || config->fn == NULL || config->period_ms == 0 ||
+        config->phase_ms >= config->period_ms) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (sched.num_jobs >= CONFIG_SCHEDULER_MAX_JOBS) {
+        ESP_LOGE(TAG, "Job table full (%d), cannot add '%s'", CONFIG_SCHEDULER_MAX_JOBS, config->name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    scheduler_job_t *job = &sched.jobs[sched.num_jobs];
+    memset(job, 0, sizeof(*job));
+    job->config = *config;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = scheduler_timer_cb,
+        .arg = job,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = config->name,
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &job->timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer for '%s': %s", config->name, esp_err_to_name(err));
+        return err;
+    }
+
+    if (xTaskCreate(scheduler_job_task, config->name, config->stack_size, job,
+                    config->priority, &job->task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create task for '%s'", config->name);
+        esp_timer_delete(job->timer);
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (job_id) {
+        *job_id = (int)sched.num_jobs;
+    }
+    sched.num_jobs++;
+
+    ESP_LOGI(TAG, "Job '%s': every %lums at +%lums", config->name,
+             (unsigned long)config->period_ms, (unsigned long)config->phase_ms);
+    return ESP_OK;
+}
+
+esp_err_t scheduler_get_stats(int job_id, scheduler_job_stats_t *stats)
+{
+    if (job_id < 0 || (size_t)job_id >= sched.num_jobs || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&sched.lock);
+    *stats = sched.jobs[job_id].stats;
+    portEXIT_CRITICAL(&sched.lock);
+    return ESP_OK;
+}
+
+size_t scheduler_get_job_count(void)
+{
+    return sched.num_jobs;
+}
+
+const char *scheduler_get_job_name(int job_id)
+{
+    if (job_id < 0 || (size_t)job_id >= sched.num_jobs) {
+        return NULL;
+    }
+    return sched.jobs[job_id].config.name;
+}
+
+void scheduler_log_stats(void)
+{
+    for (size_t i = 0; i < sched.num_jobs; i++) {
+        scheduler_job_stats_t stats;
+        scheduler_get_stats((int)i, &stats);
+        int64_t mean_jitter_us = stats.runs > 0 ? stats.total_jitter_us / stats.runs : 0;
+        ESP_LOGI(TAG, "%-14s runs=%lu missed=%lu jitter mean=%lldus max=%lldus runtime last=%lldus max=%lldus",
+                 sched.jobs[i].config.name, (unsigned long)stats.runs, (unsigned long)stats.missed,
+                 (long long)mean_jitter_us, (long long)stats.max_jitter_us,
+                 (long long)stats.last_runtime_us, (long long)stats.max_runtime_us);
+    }
+}
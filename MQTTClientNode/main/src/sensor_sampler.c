@@ -0,0 +1,225 @@
+#include "sensor_sampler.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "scheduler.h"
+#include "latency_stats.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "SENSOR_SAMPLER";
+
+#define SAMPLER_TASK_STACK         3072
+#define SAMPLER_TASK_PRIORITY      4      // Below the ADC drain task, above the publish job
+#define DHT11_SAMPLER_SETTLE_MS    30     // Start signal plus ~25ms transaction
+#define DHT11_SAMPLER_POLL_MS      10
+#define DHT11_SAMPLER_POLL_TRIES   5
+#define SEQLOCK_SPIN_TRIES         16     // Reader retries before yielding to a preempted writer
+
+// Latest readings of one sensor family. Each snapshot has exactly one writer
+// (its sampling task); readers retry instead of locking. seq is odd while
+// the writer is copying.
+typedef struct {
+    atomic_uint seq;
+    size_t count;
+    int64_t updated_us;
+    union {
+        dht11_data_t dht11[CONFIG_DHT11_MAX_SENSORS];
+        hygrometer_data_t hygro[CONFIG_HYGROMETER_MAX_PROBES];
+    } readings;
+} sensor_snapshot_t;
+
+static sensor_snapshot_t dht11_snapshot;
+static sensor_snapshot_t hygro_snapshot;
+
+static bool started = false;
+
+// Sensor counts, fixed when sampling starts
+static size_t dht11_count = 0;
+static size_t hygro_count = 0;
+
+// Writer side: publish count entries of size bytes each
+static void snapshot_write(sensor_snapshot_t *snap, const void *data, size_t count, size_t size)
+{
+    unsigned seq = atomic_load_explicit(&snap->seq, memory_order_relaxed);
+    atomic_store_explicit(&snap->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    memcpy(&snap->readings, data, count * size);
+    snap->count = count;
+    snap->updated_us = esp_timer_get_time();
+
+    atomic_store_explicit(&snap->seq, seq + 2, memory_order_release);
+}
+
+// Reader side: copy a consistent snapshot, retrying if a write overlapped
+static size_t snapshot_read(sensor_snapshot_t *snap, void *data, size_t max, size_t size, int64_t *updated_us)
+{
+    size_t count;
+    int64_t updated;
+
+    for (unsigned tries = 1; ; tries++) {
+        unsigned begin = atomic_load_explicit(&snap->seq, memory_order_acquire);
+        if ((begin & 1) == 0) {
+            count = snap->count < max ? snap->count : max;
+            memcpy(data, &snap->readings, count * size);
+            updated = snap->updated_us;
+
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&snap->seq, memory_order_relaxed) == begin) {
+                break;
+            }
+        }
+        // A write takes microseconds; only a writer preempted on this core
+        // by a higher-priority reader needs the reader to step aside
+        if (tries % SEQLOCK_SPIN_TRIES == 0) {
+            vTaskDelay(1);
+        }
+    }
+
+    if (updated_us) {
+        *updated_us = updated;
+    }
+    return count;
+}
+
+// Scheduler job: one DHT11 transaction for all sensors
+static void dht11_sample_job(void *arg)
+{
+    dht11_data_t data[CONFIG_DHT11_MAX_SENSORS];
+    int64_t start_us = esp_timer_get_time();
+
+    // Sensors that cannot be read this round report their cached value, or
+    // an invalid reading if they have none yet
+    memset(data, 0, sizeof(data));
+    for (size_t i = 0; i < dht11_count; i++) {
+        dht11_manager_get_cached(i, &data[i]);
+    }
+
+    // ESP_ERR_INVALID_STATE: the last cycle's read outlived its poll budget.
+    // Polling it collects its results; past its deadline the manager closes
+    // it and reports its sensors as failed reads, so it cannot stay stuck.
+    esp_err_t err = dht11_manager_start_read();
+    if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) {
+        if (err == ESP_OK) {
+            vTaskDelay(pdMS_TO_TICKS(DHT11_SAMPLER_SETTLE_MS));
+        }
+
+        for (size_t i = 0; i < dht11_count; i++) {
+            dht11_data_t reading;
+            err = dht11_manager_poll(i, &reading);
+            for (int t = 0; err == ESP_ERR_NOT_FINISHED && t < DHT11_SAMPLER_POLL_TRIES; t++) {
+                vTaskDelay(pdMS_TO_TICKS(DHT11_SAMPLER_POLL_MS));
+                err = dht11_manager_poll(i, &reading);
+            }
+
+            if (err == ESP_OK) {
+                data[i] = reading;
+                ESP_LOGD(TAG, "DHT11 %u read: Temp=%.1f°C, Humidity=%.1f%%", (unsigned)i,
+                         reading.temperature, reading.humidity);
+            } else if (err == ESP_ERR_NOT_FINISHED) {
+                ESP_LOGW(TAG, "DHT11 read still running after the poll budget, collecting it next cycle");
+                break;
+            } else if (err != ESP_ERR_NOT_ALLOWED) {
+                // Failures are already logged by the manager; a paused sensor is silent
+                ESP_LOGD(TAG, "Failed to read DHT11 on GPIO %d, using cached data",
+                         dht11_manager_get_gpio(i));
+            }
+        }
+    }
+
+    latency_record(LATENCY_STAGE_DHT11_READ, esp_timer_get_time() - start_us);
+    snapshot_write(&dht11_snapshot, data, dht11_count, sizeof(data[0]));
+}
+
+// Scheduler job: one conversion sequence over all probes
+static void hygro_sample_job(void *arg)
+{
+    hygrometer_data_t data[CONFIG_HYGROMETER_MAX_PROBES];
+    int64_t start_us = esp_timer_get_time();
+
+    memset(data, 0, sizeof(data));
+    esp_err_t err = hygrometer_manager_read_all(data, hygro_count);
+    if (err != ESP_OK && err != ESP_ERR_NOT_FINISHED) {
+        ESP_LOGW(TAG, "Failed to read hygrometer, using cached data");
+    }
+
+    for (size_t i = 0; i < hygro_count; i++) {
+        if (data[i].valid) {
+            ESP_LOGD(TAG, "Hygrometer %u read: Moisture=%u.%02u%%", (unsigned)i,
+                     data[i].moisture_x100 / 100, data[i].moisture_x100 % 100);
+        } else {
+            hygrometer_manager_get_cached(i, &data[i]);
+        }
+    }
+
+    latency_record(LATENCY_STAGE_ADC_READ, esp_timer_get_time() - start_us);
+    snapshot_write(&hygro_snapshot, data, hygro_count, sizeof(data[0]));
+}
+
+esp_err_t sensor_sampler_start(void)
+{
+    if (started) {
+        ESP_LOGW(TAG, "Sensor sampler already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+    started = true;
+
+    dht11_count = dht11_manager_get_sensor_count();
+    if (dht11_count > CONFIG_DHT11_MAX_SENSORS) {
+        dht11_count = CONFIG_DHT11_MAX_SENSORS;
+    }
+    hygro_count = hygrometer_manager_get_probe_count();
+    if (hygro_count > CONFIG_HYGROMETER_MAX_PROBES) {
+        hygro_count = CONFIG_HYGROMETER_MAX_PROBES;
+    }
+
+    if (dht11_count > 0) {
+        const scheduler_job_config_t job = {
+            .name = "dht11_sampler",
+            .fn = dht11_sample_job,
+            .period_ms = CONFIG_DHT11_READ_INTERVAL,
+            .phase_ms = CONFIG_DHT11_SAMPLE_PHASE_MS,
+            .stack_size = SAMPLER_TASK_STACK,
+            .priority = SAMPLER_TASK_PRIORITY,
+        };
+        esp_err_t err = scheduler_add_job(&job, NULL);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to schedule DHT11 sampling");
+            return err;
+        }
+    }
+
+    if (hygro_count > 0) {
+        const scheduler_job_config_t job = {
+            .name = "hygro_sampler",
+            .fn = hygro_sample_job,
+            .period_ms = CONFIG_HYGROMETER_READ_INTERVAL,
+            .phase_ms = CONFIG_HYGROMETER_SAMPLE_PHASE_MS,
+            .stack_size = SAMPLER_TASK_STACK,
+            .priority = SAMPLER_TASK_PRIORITY,
+        };
+        esp_err_t err = scheduler_add_job(&job, NULL);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to schedule hygrometer sampling");
+            return err;
+        }
+    }
+
+    ESP_LOGI(TAG, "Sampling %u DHT11 sensor(s), %u hygrometer probe(s)",
+             (unsigned)dht11_count, (unsigned)hygro_count);
+    return ESP_OK;
+}
+
+size_t sensor_sampler_get_dht11(dht11_data_t *data, size_t max_sensors, int64_t *updated_us)
+{
+    return snapshot_read(&dht11_snapshot, data, max_sensors, sizeof(data[0]), updated_us);
+}
+
+size_t sensor_sampler_get_hygrometer(hygrometer_data_t *data, size_t max_probes, int64_t *updated_us)
+{
+    return snapshot_read(&hygro_snapshot, data, max_probes, sizeof(data[0]), updated_us);
+}
@@ -0,0 +1,138 @@
+#include "signal_filter.h"
+#include <string.h>
+
+// 1.4826 scales the MAD to a standard deviation for Gaussian noise
+#define HAMPEL_MAD_SCALE_X1000  1483
+
+void signal_median_init(signal_median_t *m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+int32_t signal_median_update(signal_median_t *m, int32_t sample)
+{
+    int n = m->count;
+
+    if (n == SIGNAL_FILTER_WINDOW) {
+        // Drop the oldest sample from the sorted copy
+        int32_t oldest = m->window[m->pos];
+        int i = 0;
+        while (m->sorted[i] != oldest) {
+            i++;
+        }
+        for (; i < n - 1; i++) {
+            m->sorted[i] = m->sorted[i + 1];
+        }
+        n--;
+    } else {
+        m->count++;
+    }
+
+    // Insert the new sample in order
+    int i = n;
+    while (i > 0 && m->sorted[i - 1] > sample) {
+        m->sorted[i] = m->sorted[i - 1];
+        i--;
+    }
+    m->sorted[i] = sample;
+
+    m->window[m->pos] = sample;
+    m->pos = (m->pos + 1) % SIGNAL_FILTER_WINDOW;
+
+    return m->sorted[m->count / 2];
+}
+
+int32_t signal_median_get(const signal_median_t *m)
+{
+    return m->count ? m->sorted[m->count / 2] : 0;
+}
+
+void signal_ema_init(signal_ema_t *e, uint8_t shift)
+{
+    e->state_q8 = 0;
+    e->shift = shift;
+    e->primed = false;
+}
+
+int32_t signal_ema_update(signal_ema_t *e, int32_t sample)
+{
+    int32_t sample_q8 = sample * 256;
+
+    if (!e->primed) {
+        e->state_q8 = sample_q8;
+        e->primed = true;
+    } else {
+        e->state_q8 += (sample_q8 - e->state_q8) >> e->shift;
+    }
+
+    return (e->state_q8 + 128) >> 8;
+}
+
+void signal_hampel_init(signal_hampel_t *h, uint16_t k_x10, int32_t min_threshold)
+{
+    signal_median_init(&h->median);
+    h->k_x10 = k_x10;
+    h->min_threshold = min_threshold;
+    h->rejected = 0;
+}
+
+int32_t signal_hampel_update(signal_hampel_t *h, int32_t sample)
+{
+    signal_median_t *m = &h->median;
+    int32_t median = signal_median_update(m, sample);
+    int n = m->count;
+
+    // MAD: median of the absolute deviations, sorted by insertion (n <= window)
+    int32_t dev[SIGNAL_FILTER_WINDOW];
+    for (int i = 0; i < n; i++) {
+        int32_t d = m->sorted[i] - median;
+        d = d < 0 ? -d : d;
+        int j = i;
+        while (j > 0 && dev[j - 1] > d) {
+            dev[j] = dev[j - 1];
+            j--;
+        }
+        dev[j] = d;
+    }
+    int32_t mad = dev[n / 2];
+
+    int32_t threshold = (int32_t)(((int64_t)mad * HAMPEL_MAD_SCALE_X1000 * h->k_x10) / 10000);
+    if (threshold < h->min_threshold) {
+        threshold = h->min_threshold;
+    }
+
+    int32_t deviation = sample - median;
+    if (deviation > threshold || deviation < -threshold) {
+        h->rejected++;
+        return median;
+    }
+
+    return sample;
+}
+
+void signal_filter_init(signal_filter_t *f, uint8_t ema_shift, uint16_t k_x10, int32_t min_threshold)
+{
+    signal_hampel_init(&f->hampel, k_x10, min_threshold);
+    signal_ema_init(&f->ema, ema_shift);
+}
+
+int32_t signal_filter_update(signal_filter_t *f, int32_t sample)
+{
+    int32_t clean = signal_hampel_update(&f->hampel, sample);
+
+    if (!f->ema.primed) {
+        // Until the window is full the Hampel stage cannot judge outliers, so
+        // hold the EMA back and seed it with the full-window median instead
+        if (f->hampel.median.count < SIGNAL_FILTER_WINDOW) {
+            return signal_median_get(&f->hampel.median);
+        }
+        clean = signal_median_get(&f->hampel.median);
+    }
+
+    return signal_ema_update(&f->ema, clean);
+}
+
+int32_t signal_filter_get(const signal_filter_t *f)
+{
+    return f->ema.primed ? (f->ema.state_q8 + 128) >> 8 : 0;
+}
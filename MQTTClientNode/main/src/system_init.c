@@ -13,8 +13,11 @@
 #include "mqtt_manager.h"
 #include "telnet_logger.h"
 #include "dht11_manager.h"
+#include "dht11_scanner.h"
 #include "adc_scanner.h"
 #include "hygrometer_manager.h"
+#include "offline_store.h"
+#include "sensor_sampler.h"
 
 static const char *TAG = "SYSTEM_INIT";
 
@@ -32,8 +35,13 @@ static void configure_log_levels(void)
     esp_log_level_set("SYSTEM_INIT", CONFIG_LOG_LEVEL_INIT);
     esp_log_level_set("ESP32_MQTT", CONFIG_LOG_LEVEL_MAIN);
     esp_log_level_set("DHT11_MANAGER", CONFIG_LOG_LEVEL_DHT11);
+    esp_log_level_set("DHT11_SCANNER", CONFIG_LOG_LEVEL_DHT11);
     esp_log_level_set("ADC_SCANNER", CONFIG_LOG_LEVEL_ADC);
     esp_log_level_set("HYGROMETER_MANAGER", CONFIG_LOG_LEVEL_HYGRO);
+    esp_log_level_set("OFFLINE_STORE", CONFIG_LOG_LEVEL_OFFLINE);
+    esp_log_level_set("SENSOR_SAMPLER", CONFIG_LOG_LEVEL_SAMPLER);
+    esp_log_level_set("SCHEDULER", CONFIG_LOG_LEVEL_SCHED);
+    esp_log_level_set("DIAGNOSTICS", CONFIG_LOG_LEVEL_DIAG);
     
     ESP_LOGI(TAG, "Log levels configured - Global: %d", CONFIG_APP_LOG_LEVEL);
 }
@@ -110,6 +118,17 @@ esp_err_t init_nvs(void)
     return ret;
 }
 
+esp_err_t init_offline_store(void)
+{
+#if CONFIG_OFFLINE_STORE_ENABLED
+    ESP_LOGI(TAG, "Opening offline store...");
+    return offline_store_init();
+#else
+    ESP_LOGI(TAG, "Offline store disabled in configuration");
+    return ESP_OK;
+#endif
+}
+
 esp_err_t init_logging(void)
 {
     configure_log_levels();
@@ -164,12 +183,36 @@ esp_err_t init_dht11(void)
 {
     ESP_LOGI(TAG, "Initializing DHT11 sensor...");
     
-    // Pass -1 to auto-scan all GPIOs when CONFIG_DHT11_AUTO_SCAN is true (1),
-    // otherwise use CONFIG_DHT11_GPIO for a fixed pin.
+    // Auto-scan mode probes CONFIG_DHT11_SCAN_GPIOS once and caches the result in NVS,
+    // otherwise use CONFIG_DHT11_GPIOS for fixed pins.
 #if CONFIG_DHT11_AUTO_SCAN
-    return dht11_manager_init(-1);  // Auto-scan mode
+    int dht11_gpios[CONFIG_DHT11_MAX_SENSORS];
+    size_t num_gpios = 0;
+
+    if (dht11_scanner_load_cached(dht11_gpios, CONFIG_DHT11_MAX_SENSORS, &num_gpios) == ESP_OK) {
+        ESP_LOGI(TAG, "Using %u DHT11 GPIO(s) cached from a previous scan", (unsigned)num_gpios);
+        if (dht11_manager_init(dht11_gpios, num_gpios) == ESP_OK) {
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "Cached DHT11 GPIOs rejected, scanning again");
+        dht11_scanner_clear_cached();
+    }
+
+    static const int scan_gpios[] = CONFIG_DHT11_SCAN_GPIOS;
+    esp_err_t err = dht11_scanner_probe(scan_gpios, sizeof(scan_gpios) / sizeof(scan_gpios[0]),
+                                        dht11_gpios, CONFIG_DHT11_MAX_SENSORS, &num_gpios);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = dht11_manager_init(dht11_gpios, num_gpios);
+    if (err == ESP_OK) {
+        dht11_scanner_save_cached(dht11_gpios, num_gpios);
+    }
+    return err;
 #else
-    return dht11_manager_init(CONFIG_DHT11_GPIO);  // Use configured GPIO
+    static const int dht11_gpios[] = CONFIG_DHT11_GPIOS;
+    return dht11_manager_init(dht11_gpios, sizeof(dht11_gpios) / sizeof(dht11_gpios[0]));
 #endif
 }
 
@@ -182,7 +225,14 @@ esp_err_t init_adc_scanner(void)
 esp_err_t init_hygrometer(void)
 {
     ESP_LOGI(TAG, "Initializing hygrometer sensor...");
-    return hygrometer_manager_init(CONFIG_HYGROMETER_GPIO);
+    static const hygrometer_probe_config_t probes[] = CONFIG_HYGROMETER_PROBES;
+    return hygrometer_manager_init(probes, sizeof(probes) / sizeof(probes[0]));
+}
+
+esp_err_t init_sensor_sampler(void)
+{
+    ESP_LOGI(TAG, "Starting sensor sampling tasks...");
+    return sensor_sampler_start();
 }
 
 esp_err_t init_system(void)
@@ -194,6 +244,11 @@ esp_err_t init_system(void)
         return ESP_FAIL;
     }
 
+    // Samples taken while MQTT is down are kept here
+    if (init_offline_store() != ESP_OK) {
+        ESP_LOGW(TAG, "Offline store init failed, samples taken offline will be dropped");
+    }
+
     if (init_led() != ESP_OK) {
         fatal_halt("LED manager init failed");
     }
@@ -218,14 +273,24 @@ esp_err_t init_system(void)
         ESP_LOGW(TAG, "DHT11 init failed, continuing without sensor");
     }
 
+    // The hygrometer reads through the ADC scanner
+    if (init_adc_scanner() != ESP_OK) {
+        ESP_LOGW(TAG, "ADC scanner init failed, hygrometer unavailable");
+    }
+
     if (init_hygrometer() != ESP_OK) {
         ESP_LOGW(TAG, "Hygrometer init failed, continuing without sensor");
     }
 
+    // Sensors are sampled in the background from here on
+    if (init_sensor_sampler() != ESP_OK) {
+        ESP_LOGW(TAG, "Sensor sampler init failed, readings will not update");
+    }
+
     if (init_telnet_logger() != ESP_OK) {
         ESP_LOGW(TAG, "Telnet logger init failed, continuing without it");
     } else {
         ESP_LOGI(TAG, "Telnet logger available on telnet://%s:%d", ip_address, CONFIG_TELNET_PORT);
     }
     return ESP_OK;
-}
\ No newline at end of file
+}
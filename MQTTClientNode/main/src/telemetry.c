@@ -0,0 +1,317 @@
+#include "telemetry.h"
+#include "config.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include <time.h>
+#include <string.h>
+
+// CBOR payload keys (see telemetry.h)
+enum {
+    CBOR_KEY_SCHEMA = 0,
+    CBOR_KEY_TIMESTAMP_MS = 1,
+    CBOR_KEY_IP = 2,
+    CBOR_KEY_TEMPERATURE = 3,
+    CBOR_KEY_HUMIDITY = 4,
+    CBOR_KEY_MOISTURE = 5,
+    CBOR_KEY_DHT11 = 6,
+    CBOR_KEY_HYGROMETER = 7,
+    CBOR_KEY_SAMPLES = 8
+};
+
+// Scale a float reading to tenths for fixed-point output
+static inline int16_t to_tenths(float value)
+{
+    return (int16_t)(value * 10.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+static inline bool dht11_ok(const telemetry_sample_t *s, size_t i)
+{
+    return (s->dht11_valid >> i) & 1;
+}
+
+static inline bool hygro_ok(const telemetry_sample_t *s, size_t i)
+{
+    return (s->hygro_valid >> i) & 1;
+}
+
+void telemetry_sample_fill(telemetry_sample_t *sample, int64_t timestamp_ms,
+                           const dht11_data_t *dht11, size_t dht11_count,
+                           const hygrometer_data_t *hygro, size_t hygro_count)
+{
+    memset(sample, 0, sizeof(*sample));
+    sample->timestamp_ms = timestamp_ms;
+
+    if (dht11_count > CONFIG_DHT11_MAX_SENSORS) {
+        dht11_count = CONFIG_DHT11_MAX_SENSORS;
+    }
+    if (hygro_count > CONFIG_HYGROMETER_MAX_PROBES) {
+        hygro_count = CONFIG_HYGROMETER_MAX_PROBES;
+    }
+    sample->dht11_count = (uint8_t)dht11_count;
+    sample->hygro_count = (uint8_t)hygro_count;
+
+    for (size_t i = 0; i < dht11_count; i++) {
+        if (dht11[i].valid) {
+            sample->dht11_valid |= (uint8_t)(1u << i);
+            sample->temperature_x10[i] = to_tenths(dht11[i].temperature);
+            sample->humidity_x10[i] = to_tenths(dht11[i].humidity);
+        }
+    }
+
+    for (size_t i = 0; i < hygro_count; i++) {
+        if (hygro[i].valid) {
+            sample->hygro_valid |= (uint8_t)(1u << i);
+            sample->moisture_x100[i] = hygro[i].moisture_x100;
+        }
+    }
+}
+
+static inline bool moved_beyond(int32_t value, int32_t reference, int32_t deadband)
+{
+    int32_t delta = value - reference;
+    return delta > deadband || delta < -deadband;
+}
+
+bool telemetry_sample_exceeds_deadband(const telemetry_sample_t *sample,
+                                       const telemetry_sample_t *reference)
+{
+    if (sample->dht11_count != reference->dht11_count ||
+        sample->hygro_count != reference->hygro_count ||
+        sample->dht11_valid != reference->dht11_valid ||
+        sample->hygro_valid != reference->hygro_valid) {
+        return true;
+    }
+
+    for (size_t i = 0; i < sample->dht11_count; i++) {
+        if (!dht11_ok(sample, i)) {
+            continue;
+        }
+        if (moved_beyond(sample->temperature_x10[i], reference->temperature_x10[i],
+                         CONFIG_MQTT_DEADBAND_TEMPERATURE_X10) ||
+            moved_beyond(sample->humidity_x10[i], reference->humidity_x10[i],
+                         CONFIG_MQTT_DEADBAND_HUMIDITY_X10)) {
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < sample->hygro_count; i++) {
+        if (hygro_ok(sample, i) &&
+            moved_beyond(sample->moisture_x100[i], reference->moisture_x100[i],
+                         CONFIG_MQTT_DEADBAND_MOISTURE_X100)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Write the per-sample fields into an open JSON object
+static void json_write_sample(json_writer_t *w, const telemetry_sample_t *s)
+{
+    // Local time, same format as always
+    char timestamp[32];
+    time_t secs = (time_t)(s->timestamp_ms / 1000);
+    struct tm timeinfo;
+    localtime_r(&secs, &timeinfo);
+    strftime(timestamp, sizeof(timestamp), "%d-%m-%Y %H:%M:%S", &timeinfo);
+
+    json_writer_key(w, "timestamp");
+    json_writer_string(w, timestamp);
+
+    // Add DHT11 data (first sensor at top level for compatibility)
+    json_writer_key(w, "temperature_c");
+    if (s->dht11_count > 0 && dht11_ok(s, 0)) {
+        json_writer_fixed(w, s->temperature_x10[0], 1);
+        json_writer_key(w, "humidity_pct");
+        json_writer_fixed(w, s->humidity_x10[0], 1);
+    } else {
+        json_writer_null(w);
+        json_writer_key(w, "humidity_pct");
+        json_writer_null(w);
+    }
+
+    // Multi-sensor nodes also report every sensor, keyed by GPIO
+    if (s->dht11_count > 1) {
+        json_writer_key(w, "dht11");
+        json_writer_begin_array(w);
+        for (size_t i = 0; i < s->dht11_count; i++) {
+            json_writer_begin_object(w);
+            json_writer_key(w, "gpio");
+            json_writer_int(w, dht11_manager_get_gpio(i));
+            json_writer_key(w, "temperature_c");
+            if (dht11_ok(s, i)) {
+                json_writer_fixed(w, s->temperature_x10[i], 1);
+                json_writer_key(w, "humidity_pct");
+                json_writer_fixed(w, s->humidity_x10[i], 1);
+            } else {
+                json_writer_null(w);
+                json_writer_key(w, "humidity_pct");
+                json_writer_null(w);
+            }
+            json_writer_end_object(w);
+        }
+        json_writer_end_array(w);
+    }
+
+    // Add hygrometer data (first probe at top level for compatibility)
+    json_writer_key(w, "moisture_pct");
+    if (s->hygro_count > 0 && hygro_ok(s, 0)) {
+        json_writer_fixed(w, s->moisture_x100[0], 2);
+    } else {
+        json_writer_null(w);
+    }
+
+    // Multi-probe nodes also report every probe, keyed by GPIO
+    if (s->hygro_count > 1) {
+        json_writer_key(w, "hygrometer");
+        json_writer_begin_array(w);
+        for (size_t i = 0; i < s->hygro_count; i++) {
+            json_writer_begin_object(w);
+            json_writer_key(w, "gpio");
+            json_writer_int(w, hygrometer_manager_get_gpio(i));
+            json_writer_key(w, "moisture_pct");
+            if (hygro_ok(s, i)) {
+                json_writer_fixed(w, s->moisture_x100[i], 2);
+            } else {
+                json_writer_null(w);
+            }
+            json_writer_end_object(w);
+        }
+        json_writer_end_array(w);
+    }
+}
+
+size_t telemetry_encode_json(char *buf, size_t buf_size, const char *client_id, const char *ip,
+                             const telemetry_sample_t *samples, size_t count)
+{
+    if (samples == NULL || count == 0) {
+        return 0;
+    }
+
+    json_writer_t w;
+    json_writer_init(&w, buf, buf_size);
+    json_writer_begin_object(&w);
+
+    // Add metadata
+    json_writer_key(&w, "client_id");
+    json_writer_string(&w, client_id);
+    json_writer_key(&w, "ip");
+    json_writer_string(&w, ip);
+
+    if (count == 1) {
+        json_write_sample(&w, &samples[0]);
+    } else {
+        json_writer_key(&w, "samples");
+        json_writer_begin_array(&w);
+        for (size_t i = 0; i < count; i++) {
+            json_writer_begin_object(&w);
+            json_write_sample(&w, &samples[i]);
+            json_writer_end_object(&w);
+        }
+        json_writer_end_array(&w);
+    }
+
+    json_writer_end_object(&w);
+    return json_writer_finish(&w);
+}
+
+// Number of per-sample map entries (keys 1 and 3-7)
+static size_t cbor_sample_fields(const telemetry_sample_t *s)
+{
+    return 5 + (s->dht11_count > 1) + (s->hygro_count > 1);
+}
+
+// Write the per-sample key/value pairs into an open CBOR map
+static void cbor_write_sample(cbor_writer_t *w, const telemetry_sample_t *s)
+{
+    cbor_writer_uint(w, CBOR_KEY_TIMESTAMP_MS);
+    cbor_writer_uint(w, s->timestamp_ms > 0 ? (uint64_t)s->timestamp_ms : 0);
+
+    // First sensor / probe at top level, fixed-point integers
+    bool dht11_valid = s->dht11_count > 0 && dht11_ok(s, 0);
+    cbor_writer_uint(w, CBOR_KEY_TEMPERATURE);
+    if (dht11_valid) {
+        cbor_writer_int(w, s->temperature_x10[0]);
+    } else {
+        cbor_writer_null(w);
+    }
+    cbor_writer_uint(w, CBOR_KEY_HUMIDITY);
+    if (dht11_valid) {
+        cbor_writer_int(w, s->humidity_x10[0]);
+    } else {
+        cbor_writer_null(w);
+    }
+    cbor_writer_uint(w, CBOR_KEY_MOISTURE);
+    if (s->hygro_count > 0 && hygro_ok(s, 0)) {
+        cbor_writer_uint(w, s->moisture_x100[0]);
+    } else {
+        cbor_writer_null(w);
+    }
+
+    // Multi-sensor nodes: [gpio, temperature, humidity] per sensor
+    if (s->dht11_count > 1) {
+        cbor_writer_uint(w, CBOR_KEY_DHT11);
+        cbor_writer_array(w, s->dht11_count);
+        for (size_t i = 0; i < s->dht11_count; i++) {
+            cbor_writer_array(w, 3);
+            cbor_writer_int(w, dht11_manager_get_gpio(i));
+            if (dht11_ok(s, i)) {
+                cbor_writer_int(w, s->temperature_x10[i]);
+                cbor_writer_int(w, s->humidity_x10[i]);
+            } else {
+                cbor_writer_null(w);
+                cbor_writer_null(w);
+            }
+        }
+    }
+
+    // Multi-probe nodes: [gpio, moisture] per probe
+    if (s->hygro_count > 1) {
+        cbor_writer_uint(w, CBOR_KEY_HYGROMETER);
+        cbor_writer_array(w, s->hygro_count);
+        for (size_t i = 0; i < s->hygro_count; i++) {
+            cbor_writer_array(w, 2);
+            cbor_writer_int(w, hygrometer_manager_get_gpio(i));
+            if (hygro_ok(s, i)) {
+                cbor_writer_uint(w, s->moisture_x100[i]);
+            } else {
+                cbor_writer_null(w);
+            }
+        }
+    }
+}
+
+size_t telemetry_encode_cbor(uint8_t *buf, size_t buf_size, uint32_t ip4,
+                             const telemetry_sample_t *samples, size_t count)
+{
+    if (samples == NULL || count == 0) {
+        return 0;
+    }
+
+    cbor_writer_t w;
+    cbor_writer_init(&w, buf, buf_size);
+
+    if (count == 1) {
+        cbor_writer_map(&w, 2 + cbor_sample_fields(&samples[0]));
+    } else {
+        cbor_writer_map(&w, 3);
+    }
+
+    cbor_writer_uint(&w, CBOR_KEY_SCHEMA);
+    cbor_writer_uint(&w, CONFIG_TELEMETRY_SCHEMA_VERSION);
+    cbor_writer_uint(&w, CBOR_KEY_IP);
+    cbor_writer_bytes(&w, &ip4, sizeof(ip4));  // Network order: a.b.c.d
+
+    if (count == 1) {
+        cbor_write_sample(&w, &samples[0]);
+    } else {
+        cbor_writer_uint(&w, CBOR_KEY_SAMPLES);
+        cbor_writer_array(&w, count);
+        for (size_t i = 0; i < count; i++) {
+            cbor_writer_map(&w, cbor_sample_fields(&samples[i]));
+            cbor_write_sample(&w, &samples[i]);
+        }
+    }
+
+    return cbor_writer_finish(&w);
+}